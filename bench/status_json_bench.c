@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+/*
+ * Micro-benchmark of the status document decoder.
+ * Usage: status_json_bench [iterations]
+ *
+ * Each document is decoded with status_json_decode() and, for reference,
+ * with the per-key strstr() scan the tracker used before.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "status_json.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_ITERATIONS 1000000
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char doc_basic[] =
+    "{\n"
+    "    \"progress\": 42,\n"
+    "    \"status\": \"System Updating...\",\n"
+    "    \"step\": \"Downloading packages\"\n"
+    "}\n";
+
+static const char doc_full[] =
+    "{\n"
+    "    \"progress\": 42,\n"
+    "    \"status\": \"System Updating...\",\n"
+    "    \"step\": \"Downloading packages\",\n"
+    "    \"eta\": 310,\n"
+    "    \"bytes_done\": 73400320,\n"
+    "    \"bytes_total\": 167772160,\n"
+    "    \"component\": \"rootfs \\\"B\\\" slot\",\n"
+    "    \"error_code\": 0\n"
+    "}\n";
+
+static const char doc_extra[] =
+    "{\n"
+    "    \"agent\": {\"name\": \"swupdate\", \"version\": [2024, 5, 1]},\n"
+    "    \"progress\": 42,\n"
+    "    \"status\": \"System Updating...\",\n"
+    "    \"step\": \"Downloading packages\",\n"
+    "    \"eta\": 310,\n"
+    "    \"bytes_done\": 73400320,\n"
+    "    \"bytes_total\": 167772160,\n"
+    "    \"component\": \"rootfs\",\n"
+    "    \"error_code\": 0,\n"
+    "    \"log\": \"fetched chunk 35 of 80\"\n"
+    "}\n";
+
+static volatile int sink;  // keeps the compiler from dropping the decode loops
+
+/**
+ * The strstr based lookup the tracker used before the single pass decoder
+ */
+static int legacy_parse_json_value(const char* json, const char* key, char* value, size_t max_len)
+{
+    char search_key[64];
+    const char *key_pos, *value_start, *value_end;
+    size_t len;
+
+    snprintf(search_key, sizeof(search_key), "\"%s\"", key);
+    key_pos = strstr(json, search_key);
+    if (!key_pos) {
+        return 0;
+    }
+    value_start = strchr(key_pos + strlen(search_key), ':');
+    if (!value_start) {
+        return 0;
+    }
+    value_start++;
+    while (*value_start == ' ' || *value_start == '\t' || *value_start == '\n' || *value_start == '\r') {
+        value_start++;
+    }
+    if (*value_start == '"') {
+        value_start++;
+        value_end = strchr(value_start, '"');
+        if (!value_end) {
+            return 0;
+        }
+    } else {
+        value_end = value_start;
+        while (*value_end && *value_end != ',' && *value_end != '}' && *value_end != ' ' &&
+               *value_end != '\t' && *value_end != '\n' && *value_end != '\r') {
+            value_end++;
+        }
+    }
+    len = (size_t)(value_end - value_start);
+    if (len >= max_len) {
+        len = max_len - 1;
+    }
+    memcpy(value, value_start, len);
+    value[len] = '\0';
+    return 1;
+}
+
+static void legacy_decode(const char *json, update_status_t *status, int all_fields)
+{
+    char value_str[32];
+
+    if (legacy_parse_json_value(json, "progress", value_str, sizeof(value_str))) {
+        status->progress = atoi(value_str);
+    }
+    legacy_parse_json_value(json, "status", status->status, sizeof(status->status));
+    legacy_parse_json_value(json, "step", status->step, sizeof(status->step));
+    if (!all_fields) {
+        return;
+    }
+    if (legacy_parse_json_value(json, "eta", value_str, sizeof(value_str))) {
+        status->eta = atoi(value_str);
+    }
+    if (legacy_parse_json_value(json, "bytes_done", value_str, sizeof(value_str))) {
+        status->bytes_done = atoll(value_str);
+    }
+    if (legacy_parse_json_value(json, "bytes_total", value_str, sizeof(value_str))) {
+        status->bytes_total = atoll(value_str);
+    }
+    legacy_parse_json_value(json, "component", status->component, sizeof(status->component));
+    if (legacy_parse_json_value(json, "error_code", value_str, sizeof(value_str))) {
+        status->error_code = atoi(value_str);
+    }
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void run(const char *name, const char *doc, long iterations)
+{
+    size_t len = strlen(doc);
+    update_status_t status;
+    double start, decode_ns, legacy_ns;
+    int all_fields = (doc != doc_basic);
+
+    memset(&status, 0, sizeof(status));
+    if (!status_json_decode(doc, len, &status, NULL)) {
+        printf("%-8s decode failed\n", name);
+        return;
+    }
+
+    start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        sink += status_json_decode(doc, len, &status, NULL);
+    }
+    decode_ns = (now_ns() - start) / (double)iterations;
+
+    start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        legacy_decode(doc, &status, all_fields);
+        sink += status.progress;
+    }
+    legacy_ns = (now_ns() - start) / (double)iterations;
+
+    printf("%-8s %4zu bytes  decode %8.1f ns/doc %6.2f ns/byte   strstr %8.1f ns/doc\n",
+           name, len, decode_ns, decode_ns / (double)len, legacy_ns);
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = (argc > 1) ? atol(argv[1]) : DEFAULT_ITERATIONS;
+
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    printf("status_json_bench: %ld iterations per document\n", iterations);
+    run("basic", doc_basic, iterations);
+    run("full", doc_full, iterations);
+    run("extra", doc_extra, iterations);
+    return 0;
+}
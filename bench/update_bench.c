@@ -0,0 +1,312 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+/*
+ * End-to-end latency benchmark of the update tracker.
+ * Usage: update_bench [--trace file] [--rate hz] [--count n] [--socket] [--single] [--verbose]
+ *
+ * Runs the real UI on a headless memory display and replays a trace of
+ * status writes into it, by default the built-in update cycle at 100 Hz.
+ * Every write carries a sequence number. When the last area of a frame is
+ * flushed, the sequence number the widgets show has reached the pixels.
+ * --rate 0 replays with the delays recorded in the trace.
+ * --single waits until nothing draws, writes one status and fails unless it
+ * reaches the pixels on its own, without any other redraw to carry it.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#define _GNU_SOURCE /* ppoll() */
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "update_tracker.h"
+#include "events_init.h"
+#include "custom.h"
+#include "status_ingest.h"
+#include "trace_player.h"
+#include "tracker_conf.h"
+#include "tracker_stats.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DISP_HOR_RES        1280
+#define DISP_VER_RES        720
+#define DEFAULT_RATE        100     // writes per second
+#define DEFAULT_COUNT       500
+#define DRAIN_TIME_US       1000000 // wait for the last write to reach the screen
+#define MAX_EVENT_FDS       4
+#define QUIET_TIME_US       300000  // no frame for this long, the screen is static
+#define QUIET_MAX_US        10000000
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+lv_ui guider_ui;
+
+static uint64_t *write_us;      // time of each write, by sequence number
+static uint32_t *latency_us;    // write to flush of the frames that showed a write
+static uint32_t latency_cnt = 0;
+static uint32_t write_cnt = 0;
+static uint32_t shown_seq = 0;  // newest sequence number seen on screen
+static uint32_t frames = 0;
+
+static uint64_t now_us(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint32_t tick_cb(void)
+{
+    return (uint32_t)(now_us(CLOCK_MONOTONIC) / 1000);
+}
+
+/**
+ * Memory display: nothing is copied, a flush only marks what reached the pixels
+ */
+static void bench_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(px_map);
+
+    if (lv_display_flush_is_last(disp)) {
+        uint32_t seq = (uint32_t)custom_get_shown_status()->seq;
+        frames++;
+        if (seq > shown_seq && seq <= write_cnt) {
+            latency_us[latency_cnt++] = (uint32_t)(now_us(CLOCK_MONOTONIC) - write_us[seq]);
+            shown_seq = seq;
+        }
+    }
+    lv_display_flush_ready(disp);
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(uint32_t permille)
+{
+    if (latency_cnt == 0) {
+        return 0;
+    }
+    return latency_us[(uint64_t)(latency_cnt - 1) * permille / 1000];
+}
+
+static lv_display_t *display_create(void)
+{
+    lv_display_t *disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+    uint32_t size = lv_draw_buf_width_to_stride(DISP_HOR_RES, cf) * (DISP_VER_RES / 10);
+    void *buf = malloc(size + LV_DRAW_BUF_ALIGN);
+
+    lv_display_set_buffers(disp, lv_draw_buf_align(buf, cf), NULL, size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, bench_flush_cb);
+    return disp;
+}
+
+/**
+ * Sleep until an event fd is readable or the timeout expires
+ */
+static void wait_events(uint64_t timeout_us)
+{
+    struct pollfd pfds[MAX_EVENT_FDS];
+    int fds[MAX_EVENT_FDS];
+    int cnt = custom_get_event_fds(fds, MAX_EVENT_FDS);
+    struct timespec ts;
+
+    for (int i = 0; i < cnt; i++) {
+        pfds[i].fd = fds[i];
+        pfds[i].events = POLLIN;
+    }
+    ts.tv_sec = (time_t)(timeout_us / 1000000);
+    ts.tv_nsec = (long)(timeout_us % 1000000) * 1000;
+    ppoll(pfds, (nfds_t)cnt, &ts, NULL);
+}
+
+/**
+ * Run the loop until no frame was flushed for QUIET_TIME_US
+ * @return false if the screen kept drawing
+ */
+static bool wait_quiet(void)
+{
+    uint64_t start = now_us(CLOCK_MONOTONIC);
+    uint64_t last_frame = start;
+    uint32_t last_frames = frames;
+
+    for (;;) {
+        uint64_t now = now_us(CLOCK_MONOTONIC);
+        uint32_t idle;
+
+        if (frames != last_frames) {
+            last_frames = frames;
+            last_frame = now;
+        }
+        if (now - last_frame >= QUIET_TIME_US) {
+            return true;
+        }
+        if (now - start >= QUIET_MAX_US) {
+            return false;
+        }
+        custom_process_events();
+        idle = lv_timer_handler();
+        wait_events(idle == LV_NO_TIMER_READY || idle > QUIET_TIME_US / 1000 ? QUIET_TIME_US : (uint64_t)idle * 1000);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *trace = NULL;
+    uint32_t rate = DEFAULT_RATE;
+    uint32_t count = DEFAULT_COUNT;
+    bool use_socket = false;
+    bool single = false;
+    bool verbose = false;
+    uint64_t next_due, last_write = 0, cpu_start, writer_cpu = 0;
+    uint32_t seq = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace = argv[++i];
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--socket") == 0) {
+            use_socket = true;
+        } else if (strcmp(argv[i], "--single") == 0) {
+            single = true;
+            count = 1;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--trace file] [--rate hz] [--count n] [--socket] [--single]\n"
+                            "       [--verbose]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // The tracker logs every update, keep that out of the measurement
+    if (!verbose && freopen("/dev/null", "w", stdout) == NULL) {
+        return 1;
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    display_create();
+
+    setup_ui(&guider_ui);
+    events_init(&guider_ui);
+    custom_init(&guider_ui);
+    // wait_events() polls custom_get_event_fds()
+    custom_attach_event_loop();
+
+    if (trace ? !trace_player_load(trace) : !trace_player_load_builtin()) {
+        fprintf(stderr, "No trace to replay\n");
+        return 1;
+    }
+
+    write_us = calloc(count + 1, sizeof(uint64_t));
+    latency_us = calloc(count + 1, sizeof(uint32_t));
+    if (write_us == NULL || latency_us == NULL) {
+        return 1;
+    }
+
+    // Settle the first frame before measuring
+    lv_timer_handler();
+    lv_refr_now(NULL);
+    if (single && !wait_quiet()) {
+        fprintf(stderr, "single: the screen never became static\n");
+        return 1;
+    }
+
+    cpu_start = now_us(CLOCK_PROCESS_CPUTIME_ID);
+    next_due = now_us(CLOCK_MONOTONIC);
+
+    for (;;) {
+        uint64_t now = now_us(CLOCK_MONOTONIC);
+        uint64_t timeout;
+        uint32_t idle;
+
+        if (seq <= count && now >= next_due) {
+            uint32_t index = (seq - 1) % trace_player_get_count();
+            uint64_t cpu = now_us(CLOCK_THREAD_CPUTIME_ID);
+
+            if (use_socket) {
+                char doc[TRACE_PLAYER_MAX_DOC + 32];
+                size_t len = trace_player_format(index, seq, doc, sizeof(doc));
+                status_ingest_send(UPDATE_SOCKET_PATH, doc, len);
+            } else {
+                trace_player_write(UPDATE_JSON_PATH, index, seq);
+            }
+            writer_cpu += now_us(CLOCK_THREAD_CPUTIME_ID) - cpu;
+            last_write = now_us(CLOCK_MONOTONIC);
+            write_us[seq] = last_write;
+            write_cnt = seq++;
+
+            if (rate > 0) {
+                next_due += 1000000 / rate;
+            } else {
+                // A recorded delay is the time before its own write
+                next_due = now + (uint64_t)trace_player_get_delay((seq - 1) % trace_player_get_count()) * 1000;
+            }
+        }
+
+        custom_process_events();
+        idle = lv_timer_handler();
+
+        if (seq > count && (shown_seq == count || now - last_write > DRAIN_TIME_US)) {
+            break;
+        }
+
+        now = now_us(CLOCK_MONOTONIC);
+        timeout = idle == LV_NO_TIMER_READY ? DRAIN_TIME_US : (uint64_t)idle * 1000;
+        if (seq <= count) {
+            uint64_t until_due = next_due > now ? next_due - now : 0;
+            if (until_due < timeout) {
+                timeout = until_due;
+            }
+        }
+        wait_events(timeout);
+    }
+
+    uint64_t cpu = now_us(CLOCK_PROCESS_CPUTIME_ID) - cpu_start - writer_cpu;
+    uint32_t applied = tracker_counters.updates_applied;
+
+    qsort(latency_us, latency_cnt, sizeof(uint32_t), compare_u32);
+    fprintf(stderr, "writes %u via %s, rate %u Hz%s\n", (unsigned)write_cnt, use_socket ? "socket" : "file",
+            (unsigned)rate, rate == 0 ? " (recorded delays)" : "");
+    fprintf(stderr, "shown %u, not shown %u (replaced before a frame, or no visible change)\n",
+            (unsigned)latency_cnt, (unsigned)(write_cnt - latency_cnt));
+    fprintf(stderr, "write to pixel latency us: p50 %u p90 %u p99 %u max %u\n",
+            (unsigned)percentile(500), (unsigned)percentile(900), (unsigned)percentile(990),
+            (unsigned)percentile(1000));
+    fprintf(stderr, "frames %u, updates applied %u, cpu %.1f us per update (writer excluded)\n",
+            (unsigned)frames, (unsigned)applied, applied ? (double)cpu / applied : 0.0);
+
+    // Stage breakdown, when the tracker is built with UPDATE_TRACKER_USE_STATS
+    char report[4096];
+    if (tracker_stats_format(report, sizeof(report)) > 0) {
+        fputs(report, stderr);
+    }
+
+    if (single) {
+        if (shown_seq != 1) {
+            fprintf(stderr, "single: FAIL, the status written to a static screen was never flushed\n");
+            return 1;
+        }
+        fprintf(stderr, "single: ok, shown after %u us\n", (unsigned)latency_us[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+/*
+ * Render micro-benchmark of the widgets of the update screen.
+ * Usage: widget_bench [--iterations n] [--widget name]
+ *
+ * Builds the screen of setup_scr_screen() on a headless memory display and
+ * renders one widget at a time, thousands of times:
+ *  - "snapshot" renders the widget alone into an offscreen draw buffer of
+ *    each colour format, nothing but the widget is drawn;
+ *  - "partial", "direct" and "full" invalidate the widget on the display
+ *    rendered in that mode, with the screen background behind it and the
+ *    other widgets hidden.
+ * Each row gives the time per render, per pixel rendered, the throughput and
+ * the draw tasks a render creates, to compare fonts, styles and draw units.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "update_tracker.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DISP_HOR_RES        1280
+#define DISP_VER_RES        720
+#define DEFAULT_ITERATIONS  2000
+#define WARMUP_ITERATIONS   20
+#define PARTIAL_DIVIDER     10      // partial buffer of a tenth of the screen, as the ports use
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char *name;
+    lv_obj_t *obj;
+} bench_widget_t;
+
+typedef struct {
+    const char *name;
+    lv_color_format_t cf;
+} bench_cf_t;
+
+typedef struct {
+    const char *name;
+    lv_display_render_mode_t mode;
+} bench_mode_t;
+
+/* Draw tasks counted by type while a widget renders */
+enum { TASK_FILL, TASK_BORDER, TASK_LABEL, TASK_IMAGE, TASK_OTHER, TASK_KINDS };
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+lv_ui guider_ui;
+
+static const char *const task_names[TASK_KINDS] = { "fill", "border", "label", "image", "other" };
+static uint32_t task_counts[TASK_KINDS];
+static uint64_t flushed_px = 0;
+
+static const bench_cf_t color_formats[] = {
+    { "RGB565", LV_COLOR_FORMAT_RGB565 },
+    { "RGB888", LV_COLOR_FORMAT_RGB888 },
+    { "XRGB8888", LV_COLOR_FORMAT_XRGB8888 },
+    { "ARGB8888", LV_COLOR_FORMAT_ARGB8888 },
+};
+
+static const bench_mode_t render_modes[] = {
+    { "partial", LV_DISPLAY_RENDER_MODE_PARTIAL },
+    { "direct", LV_DISPLAY_RENDER_MODE_DIRECT },
+    { "full", LV_DISPLAY_RENDER_MODE_FULL },
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t tick_cb(void)
+{
+    return (uint32_t)(now_ns() / 1000000);
+}
+
+/**
+ * Memory display: nothing is copied, a flush only counts the pixels rendered
+ */
+static void bench_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    LV_UNUSED(px_map);
+
+    flushed_px += (uint64_t)lv_area_get_size(area);
+    lv_display_flush_ready(disp);
+}
+
+static void draw_task_cb(lv_event_t *e)
+{
+    switch (lv_draw_task_get_type(lv_event_get_draw_task(e))) {
+        case LV_DRAW_TASK_TYPE_FILL: task_counts[TASK_FILL]++; break;
+        case LV_DRAW_TASK_TYPE_BORDER: task_counts[TASK_BORDER]++; break;
+        case LV_DRAW_TASK_TYPE_LABEL: task_counts[TASK_LABEL]++; break;
+        case LV_DRAW_TASK_TYPE_IMAGE: task_counts[TASK_IMAGE]++; break;
+        default: task_counts[TASK_OTHER]++; break;
+    }
+}
+
+/**
+ * Give the display buffers of a colour format and render mode
+ * @return the buffer, to free once the display moves on
+ */
+static void *display_configure(lv_display_t *disp, lv_color_format_t cf, lv_display_render_mode_t mode)
+{
+    uint32_t lines = mode == LV_DISPLAY_RENDER_MODE_PARTIAL ? DISP_VER_RES / PARTIAL_DIVIDER : DISP_VER_RES;
+    uint32_t size = lv_draw_buf_width_to_stride(DISP_HOR_RES, cf) * lines;
+    void *buf = malloc(size + LV_DRAW_BUF_ALIGN);
+
+    if (buf == NULL) {
+        return NULL;
+    }
+    lv_display_set_color_format(disp, cf);
+    lv_display_set_buffers(disp, lv_draw_buf_align(buf, cf), NULL, size, mode);
+    return buf;
+}
+
+static void print_row(const char *widget, const char *target, const char *cf, uint32_t iterations,
+                      uint64_t elapsed_ns, uint64_t px)
+{
+    char tasks[64];
+    size_t pos = 0;
+    uint32_t task_total = 0;
+
+    tasks[0] = '\0';
+    for (int i = 0; i < TASK_KINDS; i++) {
+        if (task_counts[i] && pos < sizeof(tasks)) {
+            int n = snprintf(&tasks[pos], sizeof(tasks) - pos, "%s%s:%u", pos ? "," : "", task_names[i],
+                             (unsigned)((task_counts[i] + iterations / 2) / iterations));
+            pos += n > 0 ? (size_t)n : 0;
+        }
+        task_total += task_counts[i];
+    }
+
+    printf("%-12s %-8s %-9s %10.0f %8.2f %9.1f %9.0f  %s\n", widget, target, cf,
+           (double)elapsed_ns / iterations, px ? (double)elapsed_ns / (double)px : 0.0,
+           elapsed_ns ? (double)px * 1000.0 / (double)elapsed_ns : 0.0,
+           task_total ? (double)elapsed_ns / task_total : 0.0, tasks);
+}
+
+#if LV_USE_SNAPSHOT
+/**
+ * Render a widget alone into an offscreen buffer
+ */
+static void bench_snapshot(const bench_widget_t *w, const bench_cf_t *cf, uint32_t iterations)
+{
+    lv_draw_buf_t *buf = lv_snapshot_create_draw_buf(w->obj, cf->cf);
+    uint64_t start;
+
+    if (buf == NULL) {
+        fprintf(stderr, "%s: no memory for a %s snapshot\n", w->name, cf->name);
+        return;
+    }
+    for (uint32_t i = 0; i < WARMUP_ITERATIONS; i++) {
+        lv_snapshot_take_to_draw_buf(w->obj, cf->cf, buf);
+    }
+
+    memset(task_counts, 0, sizeof(task_counts));
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        lv_snapshot_take_to_draw_buf(w->obj, cf->cf, buf);
+    }
+    print_row(w->name, "snapshot", cf->name, iterations, now_ns() - start,
+              (uint64_t)buf->header.w * buf->header.h * iterations);
+    lv_draw_buf_destroy(buf);
+}
+#endif
+
+/**
+ * Render a widget on the display, the only visible child of the screen
+ */
+static void bench_display(lv_display_t *disp, const bench_widget_t *w, const char *target, const char *cf,
+                          uint32_t iterations)
+{
+    uint64_t start;
+
+    for (uint32_t i = 0; i < WARMUP_ITERATIONS; i++) {
+        lv_obj_invalidate(w->obj);
+        lv_refr_now(disp);
+    }
+
+    memset(task_counts, 0, sizeof(task_counts));
+    flushed_px = 0;
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        lv_obj_invalidate(w->obj);
+        lv_refr_now(disp);
+    }
+    print_row(w->name, target, cf, iterations, now_ns() - start, flushed_px);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    const char *only = NULL;
+    lv_display_t *disp;
+    void *disp_buf;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--widget") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations n] [--widget name]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    disp = lv_display_create(DISP_HOR_RES, DISP_VER_RES);
+    lv_display_set_flush_cb(disp, bench_flush_cb);
+    disp_buf = display_configure(disp, LV_COLOR_FORMAT_XRGB8888, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    if (disp_buf == NULL) {
+        return 1;
+    }
+
+    setup_ui(&guider_ui);
+
+    const bench_widget_t widgets[] = {
+        { "logo", guider_ui.screen_Stratus },
+        { "status_36px", guider_ui.screen_status },
+        { "progress_32px", guider_ui.screen_progress },
+        { "step_24px", guider_ui.screen_step },
+        { "bar_border", guider_ui.screen_loading_bar_border },
+        { "bar", guider_ui.screen_loading_bar },
+    };
+    const size_t widget_cnt = sizeof(widgets) / sizeof(widgets[0]);
+
+    for (size_t i = 0; i < widget_cnt; i++) {
+        lv_obj_add_flag(widgets[i].obj, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS);
+        lv_obj_add_event_cb(widgets[i].obj, draw_task_cb, LV_EVENT_DRAW_TASK_ADDED, NULL);
+    }
+
+    printf("%u iterations, %dx%d display, the display rows include the screen background\n",
+           (unsigned)iterations, DISP_HOR_RES, DISP_VER_RES);
+    printf("%-12s %-8s %-9s %10s %8s %9s %9s  %s\n", "widget", "target", "format", "ns/render", "ns/px",
+           "Mpx/s", "ns/task", "tasks/render");
+
+    for (size_t i = 0; i < widget_cnt; i++) {
+        const bench_widget_t *w = &widgets[i];
+
+        if (only != NULL && strcmp(only, w->name) != 0) {
+            continue;
+        }
+        for (size_t j = 0; j < widget_cnt; j++) {
+            if (j == i) {
+                lv_obj_remove_flag(widgets[j].obj, LV_OBJ_FLAG_HIDDEN);
+            } else {
+                lv_obj_add_flag(widgets[j].obj, LV_OBJ_FLAG_HIDDEN);
+            }
+        }
+        lv_refr_now(disp);
+
+#if LV_USE_SNAPSHOT
+        for (size_t c = 0; c < sizeof(color_formats) / sizeof(color_formats[0]); c++) {
+            bench_snapshot(w, &color_formats[c], iterations);
+        }
+#endif
+        for (size_t m = 0; m < sizeof(render_modes) / sizeof(render_modes[0]); m++) {
+            for (size_t c = 0; c < sizeof(color_formats) / sizeof(color_formats[0]); c++) {
+                void *buf = display_configure(disp, color_formats[c].cf, render_modes[m].mode);
+                if (buf == NULL) {
+                    fprintf(stderr, "No memory for a %s %s display\n", render_modes[m].name, color_formats[c].name);
+                    continue;
+                }
+                free(disp_buf);
+                disp_buf = buf;
+                bench_display(disp, w, render_modes[m].name, color_formats[c].name, iterations);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -14,13 +14,31 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <time.h>
 #include "lvgl.h"
 #include "../generated/update_tracker.h"
 #include "custom.h"
+#include "idle_mode.h"
+#include "ingest_thread.h"
+#include "tracker_conf.h"
+#include "status_watch.h"
+#include "status_json.h"
+#include "status_ingest.h"
+#include "status_publish.h"
+#include "job_list.h"
+#include "poll_sched.h"
+#include "progress_engine.h"
+#include "startup.h"
+#include "static_layer.h"
+#include "status_binary.h"
+#include "status_jobs.h"
+#include "status_history.h"
+#include "status_msgq.h"
+#include "tracker_log.h"
+#include "tracker_stats.h"
+#include "trace_player.h"
+#include "update_status.h"
 
-/* Check if we're compiling for simulator mode */
-#if defined(SIMULATOR) || defined(BUILD_SIMULATOR) || (!defined(__linux__) && !defined(CONFIG_ZEPHYR_LVGL) && !defined(CONFIG_ZEPHYR_KERNEL))
+#if IS_SIMULATOR
     /* Standard C library inclusions for simulator */
     #include <sys/stat.h>
     #include <sys/types.h>
@@ -28,10 +46,9 @@
         #include <direct.h>
         #define mkdir(dir, mode) _mkdir(dir)
     #endif
-    #define IS_SIMULATOR 1
 #else
     /* Non-simulator target */
-    #if defined(CONFIG_ZEPHYR_LVGL) || defined(CONFIG_ZEPHYR_KERNEL)
+    #if IS_ZEPHYR
         #include <zephyr/fs/fs.h>
         #include <zephyr/kernel.h>
     #else
@@ -39,85 +56,138 @@
         #include <sys/types.h>
         #include <unistd.h>
     #endif
-    #define IS_SIMULATOR 0
 #endif
 
 /*********************
  *      DEFINES
  *********************/
-#if IS_SIMULATOR
-    /* For simulator, use a path in the current directory */
-    #define UPDATE_JSON_PATH "current_update_step.json"
-#else
-    /* For real targets (Zephyr, Yocto, etc.), use appropriate path */
-    #if defined(CONFIG_ZEPHYR_LVGL) || defined(CONFIG_ZEPHYR_KERNEL)
-        #define UPDATE_JSON_PATH "/tmp/current_update_step.json"
-    #else
-        #define UPDATE_JSON_PATH "/var/lib/update_tracker/current_update_step.json"
-    #endif
-#endif
-
-#define JSON_BUFFER_SIZE 512
+#define JSON_BUFFER_SIZE 1024
 #define DEFAULT_UPDATE_INTERVAL 2000  // Default polling interval in milliseconds
+#define TORN_READ_RETRIES 3           // Re-reads of a document caught mid-write
 
 /**********************
  *      TYPEDEFS
  **********************/
+/* Identity of one version of the status file */
 typedef struct {
-    int progress;
-    char status[64];
-    char step[64];
-} update_status_t;
+    int64_t mtime_ns;   // modification time in nanoseconds
+    uint64_t inode;     // changes when the file is replaced by a rename
+    int64_t size;
+} file_stamp_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool parse_json_value(const char* json, const char* key, char* value, size_t max_len);
-static void check_update_status(lv_ui *ui);
+static bool check_update_status(lv_ui *ui);
+static bool read_status_file(ingest_doc_t *doc);
+static bool accept_file_doc(lv_ui *ui, const ingest_doc_t *doc);
+static void apply_update_status(lv_ui *ui, const update_status_t *status);
+static void show_update_status(lv_ui *ui, const update_status_t *status);
+static void set_label_text(lv_obj_t *label, char *buf, size_t size, const char *text);
+static bool receive_pushed_status(lv_ui *ui);
+static bool receive_queued_status(lv_ui *ui);
+static void schedule_next_poll(bool changed);
 static void ensure_update_json_exists(void);
 
-#if IS_SIMULATOR
-static void simulate_update_cycle(lv_timer_t *timer);
-#endif
-
 /* File operations compatibility layer */
-static int64_t get_file_timestamp(const char* filepath);
-static bool read_file_contents(const char* filepath, char* buffer, size_t max_size);
+static bool get_file_stamp(const char* filepath, file_stamp_t *stamp);
+static bool read_file_contents(const char* filepath, char* buffer, size_t max_size, size_t *length);
 static bool write_file_contents(const char* filepath, const char* content);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
-static int64_t last_modified_time = 0;  // Stores the last modified time of the JSON file
+static file_stamp_t last_stamp;          // Stamp of the JSON file when it was last read
+static uint64_t last_content_hash = 0;   // Fingerprint of the last parsed JSON payload
 static lv_timer_t *update_timer = NULL; // Handle to the update timer
-static update_status_t current_status = {0, "System Ready", "Waiting for update"}; // Current status
+#if UPDATE_TRACKER_POLL_ADAPTIVE
+static poll_sched_t poll_sched;         // Period of update_timer while no watcher is active
+#endif
+static lv_ui *tracker_ui = NULL;        // UI updated from watch events
+static update_status_t current_status = {  // Current status
+    .progress = 0,
+    .status = "System Ready",
+    .step = "Waiting for update",
+    .eta = -1,
+};
+static update_status_t shown_status;    // What the widgets currently display
+/* Texts of the labels with UPDATE_TRACKER_STATIC_LABELS, so an update never reallocates them */
+static char status_text[UPDATE_STATUS_TEXT_LEN];
+static char step_text[UPDATE_STATUS_TEXT_LEN];
+static char progress_text[8];
+static bool shown_valid = false;        // false until the widgets show a real status
+#if UPDATE_TRACKER_COALESCE
+static bool show_pending = false;       // current_status waits for the next frame
+static bool coalescing = false;         // a display shows the pending status at refresh
+#endif
+#if UPDATE_TRACKER_USE_JOBS
+static lv_obj_t *job_list;              // concurrent updates, below the main progress
+static file_stamp_t jobs_stamp;         // Stamp of UPDATE_JOBS_PATH when it was last loaded
+#endif
+#if UPDATE_TRACKER_USE_BINARY
+static poll_sched_t binary_sched;       // Period of reading the binary record
+#endif
 
 /**
- * Get file timestamp (last modification time)
+ * Get the file stamp (modification time, inode and size)
+ * @return false if the file does not exist
  */
-static int64_t get_file_timestamp(const char* filepath)
+static bool get_file_stamp(const char* filepath, file_stamp_t *stamp)
 {
-#if defined(CONFIG_ZEPHYR_LVGL) || defined(CONFIG_ZEPHYR_KERNEL)
+    memset(stamp, 0, sizeof(*stamp));
+#if IS_ZEPHYR
     struct fs_dirent entry;
     if (fs_stat(filepath, &entry) != 0) {
-        return 0;
+        return false;
     }
-    return entry.mtime;
+    stamp->mtime_ns = (int64_t)entry.mtime * 1000000000LL;
+    stamp->size = (int64_t)entry.size;
 #else
     struct stat file_stat;
     if (stat(filepath, &file_stat) != 0) {
-        return 0;
+        return false;
     }
-    return file_stat.st_mtime;
+#if defined(__linux__)
+    stamp->mtime_ns = (int64_t)file_stat.st_mtim.tv_sec * 1000000000LL + file_stat.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    stamp->mtime_ns = (int64_t)file_stat.st_mtimespec.tv_sec * 1000000000LL + file_stat.st_mtimespec.tv_nsec;
+#else
+    stamp->mtime_ns = (int64_t)file_stat.st_mtime * 1000000000LL;
+#endif
+    stamp->inode = (uint64_t)file_stat.st_ino;
+    stamp->size = (int64_t)file_stat.st_size;
 #endif
+    return true;
+}
+
+/**
+ * Compare two file stamps
+ */
+static bool file_stamp_equal(const file_stamp_t *a, const file_stamp_t *b)
+{
+    return a->mtime_ns == b->mtime_ns && a->inode == b->inode && a->size == b->size;
+}
+
+/**
+ * 64-bit FNV-1a hash, used to fingerprint the status payload
+ */
+static uint64_t content_hash(const char *data, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
 }
 
 /**
  * Read file contents into buffer
+ * @param length receives the number of bytes read
  */
-static bool read_file_contents(const char* filepath, char* buffer, size_t max_size)
+static bool read_file_contents(const char* filepath, char* buffer, size_t max_size, size_t *length)
 {
-#if defined(CONFIG_ZEPHYR_LVGL) || defined(CONFIG_ZEPHYR_KERNEL)
+#if IS_ZEPHYR
     struct fs_file_t file;
     int ret;
     
@@ -134,6 +204,7 @@ static bool read_file_contents(const char* filepath, char* buffer, size_t max_si
         return false;
     }
     
+    *length = (size_t)ret;
     return true;
 #else
     FILE *f = fopen(filepath, "rb");
@@ -145,197 +216,285 @@ static bool read_file_contents(const char* filepath, char* buffer, size_t max_si
     size_t bytes_read = fread(buffer, 1, max_size - 1, f);
     fclose(f);
     
+    *length = bytes_read;
     return bytes_read > 0;
 #endif
 }
 
 /**
  * Write content to file
+ * The file is replaced atomically so a concurrent reader never sees a partial document
  */
 static bool write_file_contents(const char* filepath, const char* content)
 {
-#if defined(CONFIG_ZEPHYR_LVGL) || defined(CONFIG_ZEPHYR_KERNEL)
-    struct fs_file_t file;
-    int ret;
-    
-    ret = fs_open(&file, filepath, FS_O_CREATE | FS_O_WRITE);
-    if (ret != 0) {
-        return false;
-    }
-    
-    fs_write(&file, content, strlen(content));
-    fs_close(&file);
+    return status_publish_write(filepath, content, strlen(content));
+}
+
+/**
+ * Check for updates in the JSON file and update the UI elements
+ * With the ingest thread running, only take the documents it has read.
+ * @return true if a new status was applied
+ */
+static bool check_update_status(lv_ui *ui)
+{
+    ingest_doc_t doc;
+    bool applied = false;
     
-    return true;
-#else
-    FILE *f = fopen(filepath, "wb");
-    if (!f) {
-        // Try to create directory if file open fails
-        #if defined(_WIN32) || defined(_WIN64)
-            mkdir("tmp", 0777);
-        #else
-            mkdir("tmp", 0777);
-        #endif
-        
-        // Try again
-        f = fopen(filepath, "wb");
-        if (!f) {
-            return false;
+    if (ingest_thread_is_active()) {
+        while (ingest_thread_receive(&doc)) {
+            applied |= accept_file_doc(ui, &doc);
         }
+        return applied;
     }
     
-    size_t bytes_written = fwrite(content, 1, strlen(content), f);
-    fclose(f);
-    
-    return bytes_written == strlen(content);
-#endif
+    if (!read_status_file(&doc)) {
+        return false;
+    }
+    return accept_file_doc(ui, &doc);
 }
 
 /**
- * Parse a JSON string and extract a specific value
+ * Read and decode the JSON file if it changed since the last call.
+ * Touches no UI state or counters, so it can run on the ingest thread; once
+ * the thread runs, last_stamp and last_content_hash belong to it.
+ * @return true if doc holds a new document or a parse error
  */
-static bool parse_json_value(const char* json, const char* key, char* value, size_t max_len)
+static bool read_status_file(ingest_doc_t *doc)
 {
-    char search_key[64];
-    char *key_pos, *value_start, *value_end;
-    
-    // Format the key to look for in JSON
-    snprintf(search_key, sizeof(search_key), "\"%s\"", key);
+    char buffer[JSON_BUFFER_SIZE];
+    file_stamp_t stamp;
+    size_t length = 0;
+    uint64_t hash;
+    uint64_t parse_start;
+    bool parsed;
     
-    // Find the key in the JSON string
-    key_pos = strstr(json, search_key);
-    if (!key_pos) {
+    // First, check if the file has been modified since last read
+    if (!get_file_stamp(UPDATE_JSON_PATH, &stamp)) {
+        // File doesn't exist yet - don't show an error, as this might be normal during startup
+        // Only log a message every 10 seconds (to avoid flooding logs)
+        TRACKER_LOG_EVERY(TRACKER_LOG_INFO, 10000, "Waiting for update status file: %s\n", UPDATE_JSON_PATH);
         return false;
     }
     
-    // Find the beginning of the value (after the colon and any whitespace)
-    value_start = strchr(key_pos + strlen(search_key), ':');
-    if (!value_start) {
+    // Check if the file was modified since we last read it
+    if (file_stamp_equal(&stamp, &last_stamp)) {
+        // File hasn't changed since last read, no need to process it again
         return false;
     }
     
-    // Skip whitespace after colon
-    value_start++;
-    while (*value_start == ' ' || *value_start == '\t' || *value_start == '\n' || *value_start == '\r') {
-        value_start++;
+    // A document that can't fit is never complete, don't read it again until it changes
+    if (stamp.size > (int64_t)sizeof(buffer) - 1) {
+        TRACKER_LOG_EVERY(TRACKER_LOG_ERROR, 10000, "Error: Status in %s is too large (%lld bytes, %u at most)\n",
+                          UPDATE_JSON_PATH, (long long)stamp.size, (unsigned)(sizeof(buffer) - 1));
+        last_stamp = stamp;
+        doc->parse_error = true;
+        return true;
     }
     
-    // If the value is a string (starts with quote)
-    if (*value_start == '"') {
-        value_start++; // Skip the opening quote
-        value_end = strchr(value_start, '"');
-        if (!value_end) {
+    for (int attempt = 0; ; attempt++) {
+        // Read the JSON file
+        if (!read_file_contents(UPDATE_JSON_PATH, buffer, sizeof(buffer), &length)) {
+            TRACKER_LOG(TRACKER_LOG_ERROR, "Error: Could not read file %s\n", UPDATE_JSON_PATH);
             return false;
         }
         
-        // Copy the string value (limited by max_len)
-        size_t len = value_end - value_start;
-        if (len >= max_len) {
-            len = max_len - 1;
+        // Rewritten with identical content: nothing to parse or redraw
+        hash = content_hash(buffer, length);
+        if (hash == last_content_hash) {
+            last_stamp = stamp;
+            return false;
         }
-        memcpy(value, value_start, len);
-        value[len] = '\0';
-    } else {
-        // If the value is a number or boolean
-        value_end = value_start;
-        while (*value_end && *value_end != ',' && *value_end != '}' && *value_end != ' ' && 
-               *value_end != '\t' && *value_end != '\n' && *value_end != '\r') {
-            value_end++;
+        
+        // Parse the JSON content, the keys found are reported in fields.
+        // A complete document is only accepted if nobody wrote to the file meanwhile.
+        memset(&doc->status, 0, sizeof(doc->status));
+        parse_start = tracker_stats_now_us();
+        parsed = status_json_decode(buffer, length, &doc->status, &doc->fields);
+        doc->parse_us = tracker_stats_now_us() - parse_start;
+        if (parsed && (int64_t)length == stamp.size) {
+            break;
         }
         
-        size_t len = value_end - value_start;
-        if (len >= max_len) {
-            len = max_len - 1;
+        // Torn read: a producer rewrote the file in place while we read it
+        if (attempt + 1 >= TORN_READ_RETRIES) {
+            // Remember the stamp: the next write changes it and is read again, a poll is not
+            TRACKER_LOG(TRACKER_LOG_ERROR, "Error: Malformed or truncated status in %s\n", UPDATE_JSON_PATH);
+            last_stamp = stamp;
+            doc->parse_error = true;    // counted by the LVGL thread
+            return true;
+        }
+        if (!get_file_stamp(UPDATE_JSON_PATH, &stamp)) {
+            return false;
         }
-        memcpy(value, value_start, len);
-        value[len] = '\0';
     }
-    
+    last_stamp = stamp;
+    last_content_hash = hash;
+    doc->mtime_ns = stamp.mtime_ns;
+    doc->parse_error = false;
     return true;
 }
 
 /**
- * Check for updates in the JSON file and update the UI elements
+ * Apply a document of the status file on top of the current status
+ * @return true if a new status was applied
  */
-static void check_update_status(lv_ui *ui)
+static bool accept_file_doc(lv_ui *ui, const ingest_doc_t *doc)
 {
-    char buffer[JSON_BUFFER_SIZE];
-    update_status_t status = current_status;  // Start with current values
-    char value_str[32];
-    bool file_changed = false;
-    int64_t file_time;
-    static int64_t last_log_time = 0;
-    
-    // First, check if the file has been modified since last read
-    file_time = get_file_timestamp(UPDATE_JSON_PATH);
-    if (file_time == 0) {
-        // File doesn't exist yet - don't show an error, as this might be normal during startup
-        // Only log a message if the interval between logs is substantial (to avoid flooding logs)
-#if defined(CONFIG_ZEPHYR_LVGL) || defined(CONFIG_ZEPHYR_KERNEL)
-    int64_t current_time = k_uptime_get();
-#else
-    int64_t current_time = (int64_t)time(NULL) * 1000;  // Convert to milliseconds
-#endif
-        if (current_time - last_log_time > 10000) {  // Log at most every 10 seconds
-            printf("Waiting for update status file: %s\n", UPDATE_JSON_PATH);
-            last_log_time = current_time;
-        }
-        return;
-    }
+    update_status_t status = current_status;  // Keys missing from the document keep their value
     
-    // Check if the file was modified since we last read it
-    if (file_time != last_modified_time) {
-        file_changed = true;
-        last_modified_time = file_time;
-    } else {
-        // File hasn't changed since last read, no need to process it again
-        return;
+    if (doc->parse_error) {
+        tracker_counters.parse_errors++;
+        return false;
     }
     
-    // Read the JSON file
-    if (!read_file_contents(UPDATE_JSON_PATH, buffer, sizeof(buffer))) {
-        printf("Error: Could not read file %s\n", UPDATE_JSON_PATH);
-        return;
+    tracker_stats_record(TRACKER_STAT_PARSE, doc->parse_us);
+#if !IS_ZEPHYR
+    // How long the document waited for us since the producer wrote it
+    int64_t age_ns = tracker_stats_wall_ns() - doc->mtime_ns;
+    if (age_ns >= 0) {
+        tracker_stats_record(TRACKER_STAT_FILE_LATENCY, (uint64_t)age_ns / 1000);
     }
+#endif
     
-    // Parse the JSON content
-    if (parse_json_value(buffer, "progress", value_str, sizeof(value_str))) {
-        status.progress = atoi(value_str);
+    status_json_merge(&status, &doc->status, doc->fields);
+    status_history_record(&status);
+    apply_update_status(ui, &status);
+    return true;
+}
+
+/**
+ * Save a new status. The widgets follow at the start of the next frame, so a
+ * burst of statuses between two frames is only shown once.
+ */
+static void apply_update_status(lv_ui *ui, const update_status_t *status)
+{
+    // Leave idle mode, the widgets are set at the next refresh
+    idle_mode_wake();
+    
+    // Keep the timeline that led to a failure, later statuses overwrite the ring
+    if (status->error_code != 0 && current_status.error_code == 0) {
+        if (status_history_dump(UPDATE_TRACKER_HISTORY_PATH)) {
+            TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Update failed (error %ld), history written to %s\n",
+                                          (long)status->error_code, UPDATE_TRACKER_HISTORY_PATH);
+        }
     }
     
-    if (parse_json_value(buffer, "status", status.status, sizeof(status.status))) {
-        // Status successfully parsed
+    current_status = *status;
+    
+#if UPDATE_TRACKER_COALESCE
+    if (coalescing) {
+        if (show_pending) {
+            tracker_counters.updates_coalesced++;
+        } else {
+            // LVGL pauses its refresh timer while nothing is invalid, run it
+            // for the REFR_START that shows this status
+            lv_timer_t *refr_timer = lv_display_get_refr_timer(lv_display_get_default());
+            if (refr_timer != NULL) {
+                lv_timer_resume(refr_timer);
+                lv_timer_ready(refr_timer);
+            }
+        }
+        show_pending = true;
+        return;
     }
-    
-    if (parse_json_value(buffer, "step", status.step, sizeof(status.step))) {
-        // Step successfully parsed
+#endif
+    show_update_status(ui, status);
+}
+
+#if UPDATE_TRACKER_COALESCE
+/**
+ * Show the newest status right before the display refreshes
+ */
+static void refr_start_cb(lv_event_t *e)
+{
+    if (show_pending) {
+        show_pending = false;
+        show_update_status(lv_event_get_user_data(e), &current_status);
     }
-    
-    // Save the current status
-    current_status = status;
-    
-    // Update the UI elements
+}
+#endif
+
+/**
+ * Set the text of a label. With UPDATE_TRACKER_STATIC_LABELS the text is
+ * copied into buf, the label only points to it and nothing is allocated.
+ */
+static void set_label_text(lv_obj_t *label, char *buf, size_t size, const char *text)
+{
+#if UPDATE_TRACKER_STATIC_LABELS
+    snprintf(buf, size, "%s", text);
+    lv_label_set_text_static(label, buf);
+#else
+    LV_UNUSED(buf);
+    LV_UNUSED(size);
+    lv_label_set_text(label, text);
+#endif
+}
+
+/**
+ * Show a status on the UI elements
+ */
+static void show_update_status(lv_ui *ui, const update_status_t *status)
+{
+    uint32_t touched = 0;
+    uint32_t skipped = 0;
+    uint64_t apply_start = tracker_stats_now_us();
+    bool status_changed = !shown_valid || strcmp(status->status, shown_status.status) != 0;
+    bool step_changed = !shown_valid || strcmp(status->step, shown_status.step) != 0;
+    bool progress_changed = !shown_valid || status->progress != shown_status.progress;
+    
+    // Update only the UI elements whose field changed; every set re-lays out
+    // and invalidates the widget even if the value is the same
     if (ui->screen_status != NULL) {
-        lv_label_set_text(ui->screen_status, status.status);
+        if (status_changed) {
+            set_label_text(ui->screen_status, status_text, sizeof(status_text), status->status);
+            touched++;
+        } else {
+            skipped++;
+        }
     }
     
     if (ui->screen_step != NULL) {
-        lv_label_set_text(ui->screen_step, status.step);
+        if (step_changed) {
+            set_label_text(ui->screen_step, step_text, sizeof(step_text), status->step);
+            touched++;
+        } else {
+            skipped++;
+        }
     }
     
     if (ui->screen_progress != NULL) {
-        char percentage[8];
-        snprintf(percentage, sizeof(percentage), "%d%%", status.progress);
-        lv_label_set_text(ui->screen_progress, percentage);
+        if (progress_changed) {
+            char percentage[8];
+            snprintf(percentage, sizeof(percentage), "%d%%", status->progress);
+            set_label_text(ui->screen_progress, progress_text, sizeof(progress_text), percentage);
+            touched++;
+        } else {
+            skipped++;
+        }
     }
     
     if (ui->screen_loading_bar != NULL) {
-        lv_bar_set_value(ui->screen_loading_bar, status.progress, LV_ANIM_ON);
+        if (progress_changed) {
+            progress_engine_set(status->progress);
+            touched++;
+        } else {
+            skipped++;
+        }
     }
     
+    shown_status = *status;
+    shown_valid = true;
+    tracker_stats_record(TRACKER_STAT_APPLY, tracker_stats_now_us() - apply_start);
+    
+    tracker_counters.updates_applied++;
+    tracker_counters.widget_updates += touched;
+    tracker_counters.widget_updates_skipped += skipped;
+    
     // Log update for debugging
-    printf("Update status: %d%% - %s - %s\n", 
-           status.progress, status.status, status.step);
+    TRACKER_LOG(TRACKER_LOG_INFO, "Update status: %d%% - %s - %s, eta %d s (%u widgets updated, %u redraws avoided in total)\n", 
+                                  status->progress, status->status, status->step,
+                                  (int)(status->eta >= 0 ? status->eta : progress_engine_get_eta()),
+                                  (unsigned)touched, (unsigned)tracker_counters.widget_updates_skipped);
 }
 
 /**
@@ -345,18 +504,230 @@ static void check_update_status(lv_ui *ui)
 void update_tracker_task(lv_timer_t *timer)
 {
     lv_ui *ui = (lv_ui *)timer->user_data;
-    check_update_status(ui);
+    bool changed = receive_pushed_status(ui);
+    // Queued statuses do not speed up the file poll, a loop sleeping in status_msgq_wait() takes them at once
+    receive_queued_status(ui);
+    changed |= check_update_status(ui);
+    schedule_next_poll(changed);
+}
+
+/**
+ * Adapt the polling interval to the activity of the status: fast while it
+ * changes, backing off to a ceiling while it doesn't
+ * @param changed a new status was applied since the last call
+ */
+static void schedule_next_poll(bool changed)
+{
+#if UPDATE_TRACKER_POLL_ADAPTIVE
+    bool active = current_status.progress > 0 && current_status.progress < 100;
+    uint32_t prev = poll_sched.interval_ms;
+
+    if (update_timer == NULL) {
+        return;
+    }
+    if (poll_sched_next(&poll_sched, changed, active) != prev) {
+        lv_timer_set_period(update_timer, poll_sched.interval_ms);
+    }
+#else
+    LV_UNUSED(changed);
+#endif
+}
+
+/**
+ * Apply documents pushed over the ingest socket on top of the current status
+ * @return true if a new status was applied
+ */
+static bool receive_pushed_status(lv_ui *ui)
+{
+    update_status_t status = current_status;
+    uint64_t ingest_start = tracker_stats_now_us();
+    if (status_ingest_receive(&status)) {
+        tracker_stats_record(TRACKER_STAT_INGEST, tracker_stats_now_us() - ingest_start);
+        apply_update_status(ui, &status);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Apply statuses posted to the in-RAM message queue on top of the current status
+ * @return true if a new status was applied
+ */
+static bool receive_queued_status(lv_ui *ui)
+{
+    update_status_t status = current_status;
+    uint64_t ingest_start = tracker_stats_now_us();
+    if (status_msgq_receive(&status)) {
+        tracker_stats_record(TRACKER_STAT_INGEST, tracker_stats_now_us() - ingest_start);
+        apply_update_status(ui, &status);
+        return true;
+    }
+    return false;
+}
+
+#if UPDATE_TRACKER_USE_BINARY
+/**
+ * Read the mapped binary record. A read is a memory copy, so it is polled
+ * like a pushed status: fast while the record changes, slower while it doesn't.
+ */
+static void binary_task(lv_timer_t *timer)
+{
+    lv_ui *ui = (lv_ui *)timer->user_data;
+    update_status_t status = current_status;
+    uint32_t prev = binary_sched.interval_ms;
+    uint64_t read_start = tracker_stats_now_us();
+    status_binary_result_t result = STATUS_BINARY_INVALID;
+
+    if (status_binary_open(UPDATE_BINARY_PATH)) {
+        result = status_binary_read(&status);
+    }
+    if (result == STATUS_BINARY_UPDATED) {
+        tracker_stats_record(TRACKER_STAT_PARSE, tracker_stats_now_us() - read_start);
+        status_history_record(&status);
+        apply_update_status(ui, &status);
+    }
+
+    // Caught mid-write: look again soon
+    if (poll_sched_next(&binary_sched, result == STATUS_BINARY_UPDATED || result == STATUS_BINARY_TORN,
+                        current_status.progress > 0 && current_status.progress < 100) != prev) {
+        lv_timer_set_period(timer, binary_sched.interval_ms);
+    }
+}
+#endif
+
+#if UPDATE_TRACKER_USE_JOBS
+/**
+ * Reload the jobs when their document or directory changed.
+ * Publishers rename documents into place, which also updates the directory's stamp.
+ */
+static void jobs_task(lv_timer_t *timer)
+{
+    file_stamp_t stamp;
+    uint32_t version = status_jobs_get_version();
+
+    LV_UNUSED(timer);
+
+    if (!get_file_stamp(UPDATE_JOBS_PATH, &stamp)) {
+        status_jobs_clear();
+    } else if (!file_stamp_equal(&stamp, &jobs_stamp)) {
+        jobs_stamp = stamp;
+        if (!status_jobs_load_dir(UPDATE_JOBS_PATH) && !status_jobs_load_file(UPDATE_JOBS_PATH)) {
+            TRACKER_LOG(TRACKER_LOG_WARN, "Warning: Could not load the jobs of %s\n", UPDATE_JOBS_PATH);
+        }
+    }
+
+    if (status_jobs_get_version() != version) {
+        job_list_refresh(job_list);
+    }
+}
+#endif
+
+/**
+ * Get the status the widgets currently display
+ */
+const update_status_t *custom_get_shown_status(void)
+{
+    return &shown_status;
+}
+
+/**
+ * Get the descriptors the main loop should wait on in addition to the LVGL timers
+ * @param fds array to fill
+ * @param max_fds capacity of fds
+ * @return number of descriptors written
+ */
+int custom_get_event_fds(int *fds, int max_fds)
+{
+    int count = 0;
+
+    if (ingest_thread_is_active()) {
+        // The watch descriptor belongs to the ingest thread
+        if (count < max_fds) {
+            fds[count++] = ingest_thread_get_fd();
+        }
+    } else if (count < max_fds && status_watch_get_fd() >= 0) {
+        fds[count++] = status_watch_get_fd();
+    }
+    if (count < max_fds && status_ingest_get_fd() >= 0) {
+        fds[count++] = status_ingest_get_fd();
+    }
+    if (count < max_fds && tracker_stats_get_fd() >= 0) {
+        fds[count++] = tracker_stats_get_fd();
+    }
+
+    return count;
+}
+
+/**
+ * Tell the tracker that a main loop waits on the descriptors of
+ * custom_get_event_fds() and calls custom_process_events() when they are
+ * readable. The file poll then stops while a watcher or the ingest thread
+ * reports the changes; without this call it keeps running as a fallback.
+ */
+void custom_attach_event_loop(void)
+{
+    if (update_timer != NULL && (ingest_thread_is_active() || status_watch_is_active())) {
+        lv_timer_pause(update_timer);
+    }
+}
+
+/**
+ * Handle pending events on the descriptors returned by custom_get_event_fds()
+ * Must be called from the LVGL thread.
+ */
+void custom_process_events(void)
+{
+    if (tracker_ui == NULL) {
+        return;
+    }
+
+    tracker_stats_process();
+
+    if (receive_pushed_status(tracker_ui) && !ingest_thread_is_active() && !status_watch_is_active()) {
+        // A push means an update is running, poll the file fast as well
+        schedule_next_poll(true);
+    }
+    receive_queued_status(tracker_ui);
+
+    if (ingest_thread_is_active()) {
+        check_update_status(tracker_ui);
+        return;
+    }
+
+    if (!status_watch_is_active()) {
+        return;
+    }
+
+    if (status_watch_process()) {
+        check_update_status(tracker_ui);
+    }
+
+    if (!status_watch_is_active() && update_timer != NULL) {
+        // Watcher shut down, go back to polling the file
+        schedule_next_poll(true);
+        lv_timer_resume(update_timer);
+    }
 }
 
 /**
  * Set the update polling interval
+ * With UPDATE_TRACKER_POLL_ADAPTIVE this is the ceiling of the idle back-off,
+ * the interval drops to UPDATE_TRACKER_POLL_FAST_MS whenever the status changes.
  * @param interval_ms New polling interval in milliseconds
  */
 void set_update_polling_interval(uint32_t interval_ms)
 {
     if (update_timer != NULL) {
+#if UPDATE_TRACKER_POLL_ADAPTIVE
+        poll_sched_init(&poll_sched, UPDATE_TRACKER_POLL_FAST_MS, UPDATE_TRACKER_POLL_ACTIVE_MAX_MS,
+                        interval_ms, UPDATE_TRACKER_POLL_HOLD);
+        lv_timer_set_period(update_timer, UPDATE_TRACKER_POLL_FAST_MS);
+        TRACKER_LOG(TRACKER_LOG_INFO, "Update polling interval set to %d..%d ms\n",
+                    UPDATE_TRACKER_POLL_FAST_MS, interval_ms);
+#else
         lv_timer_set_period(update_timer, interval_ms);
-        printf("Update polling interval set to %d ms\n", interval_ms);
+        TRACKER_LOG(TRACKER_LOG_INFO, "Update polling interval set to %d ms\n", interval_ms);
+#endif
     }
 }
 
@@ -367,7 +738,8 @@ void set_update_polling_interval(uint32_t interval_ms)
 static void ensure_update_json_exists(void)
 {
     // Check if file already exists
-    if (get_file_timestamp(UPDATE_JSON_PATH) != 0) {
+    file_stamp_t stamp;
+    if (get_file_stamp(UPDATE_JSON_PATH, &stamp)) {
         // File exists, nothing to do
         return;
     }
@@ -380,80 +752,116 @@ static void ensure_update_json_exists(void)
                               "}\n";
     
     if (!write_file_contents(UPDATE_JSON_PATH, default_json)) {
-        printf("Error: Could not create %s\n", UPDATE_JSON_PATH);
+        TRACKER_LOG(TRACKER_LOG_ERROR, "Error: Could not create %s\n", UPDATE_JSON_PATH);
         return;
     }
     
-    printf("Created default update status file at %s\n", UPDATE_JSON_PATH);
+    TRACKER_LOG(TRACKER_LOG_INFO, "Created default update status file at %s\n", UPDATE_JSON_PATH);
 }
 
-#if IS_SIMULATOR
 /**
- * For simulator only: Simulate update process automatically
+ * Startup work the first frame does not need, run once it is flushed
  */
-static void simulate_update_cycle(lv_timer_t *timer)
+static void custom_init_deferred(void *user_data)
 {
-    lv_ui *ui = (lv_ui *)timer->user_data;
-    static int update_phase = 0;
-    static const char *update_steps[] = {
-        "Preparing for update",
-        "Downloading packages",
-        "Verifying download",
-        "Installing updates",
-        "Configuring system", 
-        "Finalizing installation",
-        "Cleaning up",
-        "Update complete."
-    };
-    static const int num_phases = sizeof(update_steps)/sizeof(update_steps[0]);
-    
-    // Calculate progress based on phase (0-100)
-    int progress = (update_phase * 100) / num_phases;
-    if (progress > 100) progress = 100;
-    
-    // Update the JSON file with new values
-    char json_content[512];
-    snprintf(json_content, sizeof(json_content), 
-             "{\n"
-             "    \"progress\": %d,\n"
-             "    \"status\": \"System Updating...\",\n"
-             "    \"step\": \"%s\"\n"
-             "}\n", 
-             progress, 
-             update_steps[update_phase]);
-    
-    write_file_contents(UPDATE_JSON_PATH, json_content);
-    
-    // Move to next phase or restart
-    update_phase++;
-    if (update_phase >= num_phases) {
-        // Cycle completed - reset or stop
-        update_phase = 0;
+    lv_ui *ui = user_data;
+    
+    /* The logo and the bar border never change: draw them once into a cached layer */
+    lv_obj_t *static_objs[] = {ui->screen_Stratus, ui->screen_loading_bar_border};
+    static_layer_bake(ui->screen, static_objs, sizeof(static_objs) / sizeof(static_objs[0]));
+    
+    /* Create the JSON file if it doesn't exist yet */
+    ensure_update_json_exists();
+    
+    /* Force the initial check to always run by forgetting the last stamp and payload.
+     * The ingest thread owns them and already read the file when it started. */
+    if (!ingest_thread_is_active()) {
+        memset(&last_stamp, 0, sizeof(last_stamp));
+        last_content_hash = 0;
+    }
+    check_update_status(ui);
+    
+#if IS_SIMULATOR
+    /* For simulator only: replay the built-in update cycle into the status file */
+    if (trace_player_load_builtin()) {
+        trace_player_start(UPDATE_JSON_PATH, 0);
+        TRACKER_LOG(TRACKER_LOG_INFO, "SIMULATOR MODE: Replaying %u built-in status changes into %s\n",
+                    (unsigned)trace_player_get_count(), UPDATE_JSON_PATH);
     }
-}
 #endif
+}
 
 /**
  * Create a demo application
  */
 void custom_init(lv_ui *ui)
 {
+    /* The bar follows the measured rate instead of restarting an animation per update */
+    if (ui->screen_loading_bar != NULL) {
+        progress_engine_init(ui->screen_loading_bar, current_status.progress);
+    }
+    
+#if UPDATE_TRACKER_USE_JOBS
+    /* Gateways: one row per downstream update, only the visible rows are created */
+    job_list = job_list_create(ui->screen, 1200, 3 * JOB_LIST_ROW_HEIGHT);
+    if (job_list != NULL) {
+        lv_obj_set_pos(job_list, 40, 590);
+        lv_timer_ready(lv_timer_create(jobs_task, UPDATE_TRACKER_JOBS_INTERVAL, NULL));
+        TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Showing the jobs of %s\n", UPDATE_JOBS_PATH);
+    }
+#endif
+    
+    /* Stop refreshing the display while nothing changes */
+    idle_mode_init(lv_display_get_default());
+    
+    /* Timing histograms, when compiled in */
+    tracker_stats_init(lv_display_get_default());
+    
+#if UPDATE_TRACKER_COALESCE
+    /* Statuses received between two frames are shown once, at refresh */
+    if (lv_display_get_default() != NULL) {
+        lv_display_add_event_cb(lv_display_get_default(), refr_start_cb, LV_EVENT_REFR_START, ui);
+        coalescing = true;
+    }
+#endif
+    
     /* Initialize update tracking */
     update_timer = lv_timer_create(update_tracker_task, DEFAULT_UPDATE_INTERVAL, ui);
+#if UPDATE_TRACKER_POLL_ADAPTIVE
+    /* Start fast, the first polls often catch an update that began before boot */
+    poll_sched_init(&poll_sched, UPDATE_TRACKER_POLL_FAST_MS, UPDATE_TRACKER_POLL_ACTIVE_MAX_MS,
+                    UPDATE_TRACKER_POLL_IDLE_MAX_MS, UPDATE_TRACKER_POLL_HOLD);
+    lv_timer_set_period(update_timer, UPDATE_TRACKER_POLL_FAST_MS);
+#endif
     
     /* Log the path where we're looking for the JSON file */
-    printf("Update tracker: Monitoring %s for update status changes\n", UPDATE_JSON_PATH);
-    
-    /* Create the JSON file if it doesn't exist yet */
-    ensure_update_json_exists();
-    
-    /* Force the initial check to always run by setting last_modified_time to 0 */
-    last_modified_time = 0;
-    check_update_status(ui);
+    TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Monitoring %s for update status changes\n", UPDATE_JSON_PATH);
+    
+    /* Prefer change notifications over polling; the timer only runs as a fallback */
+    tracker_ui = ui;
+    /* The timer keeps draining them until a main loop waits on custom_get_event_fds() */
+    if (ingest_thread_start(UPDATE_JSON_PATH, read_status_file)) {
+        TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Reading %s on the ingest thread\n", UPDATE_JSON_PATH);
+    } else if (status_watch_init(UPDATE_JSON_PATH)) {
+        TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Watching for changes with inotify\n");
+    }
     
-#if IS_SIMULATOR
-    /* For simulator only: start automatic update simulation */
-    lv_timer_create(simulate_update_cycle, 3000, ui);  // Update every 3 seconds
-    printf("SIMULATOR MODE: Auto-generating update status changes every 3 seconds\n");
+    /* Producers that can push updates directly skip the file and its disk I/O */
+    if (status_ingest_init(UPDATE_SOCKET_PATH)) {
+        TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Accepting status updates on %s\n", UPDATE_SOCKET_PATH);
+    }
+#if UPDATE_TRACKER_USE_MSGQ
+    TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Accepting status updates on the message queue\n");
+#endif
+#if UPDATE_TRACKER_USE_BINARY
+    /* The binary record is mapped once it exists, reading it needs no system call */
+    poll_sched_init(&binary_sched, UPDATE_TRACKER_POLL_FAST_MS, UPDATE_TRACKER_POLL_ACTIVE_MAX_MS,
+                    UPDATE_TRACKER_POLL_IDLE_MAX_MS, UPDATE_TRACKER_POLL_HOLD);
+    lv_timer_create(binary_task, UPDATE_TRACKER_POLL_FAST_MS, ui);
+    TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Reading binary status records from %s\n", UPDATE_BINARY_PATH);
 #endif
+    
+    /* File creation, the first check and the static layer wait for the first frame */
+    startup_after_first_frame(lv_display_get_default(), custom_init_deferred, ui);
+    startup_mark("custom_init");
 }
@@ -14,8 +14,13 @@ extern "C" {
 #endif
 
 #include "gui_guider.h"
+#include "update_status.h"
 
 void custom_init(lv_ui *ui);
+int custom_get_event_fds(int *fds, int max_fds);
+void custom_process_events(void);
+void custom_attach_event_loop(void);
+const update_status_t *custom_get_shown_status(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,40 @@
+# Glyph subsetting of the generated fonts, enabled with FONT_SUBSET=1.
+# Every custom/font_charsets/<font>.txt cuts generated/guider_fonts/<font>.c
+# down to the characters it lists. FONT_SUBSET_FALLBACK=1 also builds the
+# full fonts and makes them the runtime fallback of the subsets.
+ifeq ($(FONT_SUBSET),1)
+
+PYTHON ?= python3
+FONT_SUBSET_DIR ?= $(PRJ_DIR)/build/font_subset
+FONT_CHARSETS := $(wildcard $(PRJ_DIR)/custom/font_charsets/*.txt)
+FONT_SUBSET_FONTS := $(basename $(notdir $(FONT_CHARSETS)))
+FONT_SUBSET_ARGS = $(if $(filter 1,$(FONT_SUBSET_FALLBACK)),--fallback $(FONT_SUBSET_DIR)/$(font)_full.c)
+
+# Generated through an included makefile so the fonts exist before make
+# resolves them through VPATH, which finds the subsets first
+FONT_SUBSET_GOAL := $(.DEFAULT_GOAL)
+$(FONT_SUBSET_DIR)/fonts_subset.mk: $(FONT_CHARSETS) $(PRJ_DIR)/tools/font_subset.py \
+		$(addprefix $(PRJ_DIR)/generated/guider_fonts/,$(addsuffix .c,$(FONT_SUBSET_FONTS)))
+	@mkdir -p $(FONT_SUBSET_DIR)
+	$(foreach font,$(FONT_SUBSET_FONTS),$(PYTHON) $(PRJ_DIR)/tools/font_subset.py \
+		--font $(PRJ_DIR)/generated/guider_fonts/$(font).c \
+		--charset $(PRJ_DIR)/custom/font_charsets/$(font).txt \
+		--output $(FONT_SUBSET_DIR)/$(font).c $(FONT_SUBSET_ARGS) &&) true
+	@echo "FONT_SUBSET_FALLBACK_BUILT := $(FONT_SUBSET_FALLBACK)" > $@
+.DEFAULT_GOAL := $(FONT_SUBSET_GOAL)
+
+-include $(FONT_SUBSET_DIR)/fonts_subset.mk
+
+# Regenerate when the fallback setting changed since the last run
+ifneq ($(FONT_SUBSET_FALLBACK_BUILT),$(FONT_SUBSET_FALLBACK))
+$(FONT_SUBSET_DIR)/fonts_subset.mk: font_subset_force
+.PHONY: font_subset_force
+endif
+
+ifeq ($(FONT_SUBSET_FALLBACK),1)
+GEN_CSRCS += $(addsuffix _full.c,$(FONT_SUBSET_FONTS))
+endif
+
+VPATH := $(FONT_SUBSET_DIR):$(VPATH)
+
+endif
@@ -0,0 +1,130 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include "tracker_conf.h"
+#include "idle_mode.h"
+#include "tracker_stats.h"
+
+#if UPDATE_TRACKER_USE_IDLE
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CHECK_PERIOD    (UPDATE_TRACKER_IDLE_TIMEOUT / 4 > 250 ? UPDATE_TRACKER_IDLE_TIMEOUT / 4 : 250)
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_display_t *idle_disp;
+static lv_timer_t *check_timer;
+static idle_mode_power_cb_t power_cb;
+static uint32_t last_activity;      // tick of the last invalidation
+static uint32_t idle_since;
+static bool idle = false;
+
+/**
+ * Stop the refresh timer and the check itself, nothing is left to draw
+ */
+static void enter_idle(void)
+{
+    lv_timer_pause(lv_display_get_refr_timer(idle_disp));
+    lv_timer_pause(check_timer);
+    idle = true;
+    idle_since = lv_tick_get();
+    tracker_counters.idle_entries++;
+    if (power_cb != NULL) {
+        power_cb(true);
+    }
+}
+
+static void check_timer_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+    if (!idle && lv_tick_elaps(last_activity) >= UPDATE_TRACKER_IDLE_TIMEOUT) {
+        enter_idle();
+    }
+}
+
+/**
+ * Every invalidation counts as activity, and ends idle mode
+ */
+static void invalidate_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    if (idle) {
+        idle_mode_wake();
+    }
+    last_activity = lv_tick_get();
+}
+
+void idle_mode_init(lv_display_t *disp)
+{
+    if (disp == NULL || check_timer != NULL) {
+        return;
+    }
+    idle_disp = disp;
+    last_activity = lv_tick_get();
+    lv_display_add_event_cb(disp, invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    check_timer = lv_timer_create(check_timer_cb, CHECK_PERIOD, NULL);
+}
+
+void idle_mode_set_power_cb(idle_mode_power_cb_t cb)
+{
+    power_cb = cb;
+}
+
+void idle_mode_wake(void)
+{
+    last_activity = lv_tick_get();
+    if (!idle) {
+        return;
+    }
+    idle = false;
+    tracker_counters.idle_ms += lv_tick_elaps(idle_since);
+    if (power_cb != NULL) {
+        power_cb(false);
+    }
+    // Draw what woke us up without waiting for the next period
+    lv_timer_resume(lv_display_get_refr_timer(idle_disp));
+    lv_timer_ready(lv_display_get_refr_timer(idle_disp));
+    lv_timer_resume(check_timer);
+}
+
+bool idle_mode_is_idle(void)
+{
+    return idle;
+}
+
+#else /* UPDATE_TRACKER_USE_IDLE */
+
+void idle_mode_init(lv_display_t *disp)
+{
+    LV_UNUSED(disp);
+}
+
+void idle_mode_set_power_cb(idle_mode_power_cb_t cb)
+{
+    LV_UNUSED(cb);
+}
+
+void idle_mode_wake(void)
+{
+}
+
+bool idle_mode_is_idle(void)
+{
+    return false;
+}
+
+#endif /* UPDATE_TRACKER_USE_IDLE */
@@ -0,0 +1,56 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * idle_mode - stop refreshing the display while the screen is static.
+ * After UPDATE_TRACKER_IDLE_TIMEOUT ms without an invalidated area, the
+ * display's refresh timer is paused and the power callback is told to save
+ * power. Any invalidation, status change or input resumes at once.
+ */
+
+#ifndef IDLE_MODE_H_
+#define IDLE_MODE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include "lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * Called when the display enters (idle true) or leaves idle mode
+ */
+typedef void (*idle_mode_power_cb_t)(bool idle);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Watch the invalidations of a display. Does nothing unless built with
+ * UPDATE_TRACKER_USE_IDLE.
+ */
+void idle_mode_init(lv_display_t *disp);
+
+void idle_mode_set_power_cb(idle_mode_power_cb_t cb);
+
+/**
+ * Leave idle mode, e.g. on input or a new status
+ */
+void idle_mode_wake(void);
+
+bool idle_mode_is_idle(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* IDLE_MODE_H_ */
@@ -0,0 +1,211 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "tracker_conf.h"
+#include "tracker_log.h"
+#include "ingest_thread.h"
+#include "poll_sched.h"
+#include "status_watch.h"
+
+#if UPDATE_TRACKER_USE_INGEST_THREAD
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <pthread.h>
+    #include <stdatomic.h>
+    #include <unistd.h>
+#endif
+
+#if UPDATE_TRACKER_USE_INGEST_THREAD
+
+/*********************
+ *      DEFINES
+ *********************/
+#define QUEUE_LEN       8           // documents in flight, a power of two
+#define QUEUE_MASK      (QUEUE_LEN - 1)
+#define FULL_WAIT_US    2000        // producer back-off while the LVGL thread catches up
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static ingest_doc_t queue[QUEUE_LEN];
+static atomic_uint queue_head;      // next slot the ingest thread writes
+static atomic_uint queue_tail;      // next slot the LVGL thread reads
+static int wake_fds[2] = { -1, -1 };
+static ingest_read_cb_t read_file;
+static pthread_t thread;
+static bool active = false;
+
+/**
+ * Publish one document, waiting while the queue is full
+ */
+static void queue_push(const ingest_doc_t *doc)
+{
+    unsigned int head = atomic_load_explicit(&queue_head, memory_order_relaxed);
+    const char wake = 1;
+
+    while (head - atomic_load_explicit(&queue_tail, memory_order_acquire) >= QUEUE_LEN) {
+        usleep(FULL_WAIT_US);
+    }
+    queue[head & QUEUE_MASK] = *doc;
+    atomic_store_explicit(&queue_head, head + 1, memory_order_release);
+
+    // A full pipe already holds a wakeup
+    if (write(wake_fds[1], &wake, 1) < 0 && errno != EAGAIN) {
+        TRACKER_LOG_EVERY(TRACKER_LOG_WARN, 10000, "Update tracker: Cannot wake the LVGL thread (%s)\n", strerror(errno));
+    }
+}
+
+/**
+ * Wait for changes of the status file, read and parse it, hand the documents over
+ */
+static void *ingest_main(void *arg)
+{
+    poll_sched_t sched;
+    ingest_doc_t doc;
+    bool updating = false;
+
+    (void)arg;
+    poll_sched_init(&sched, UPDATE_TRACKER_POLL_FAST_MS, UPDATE_TRACKER_POLL_ACTIVE_MAX_MS,
+                    UPDATE_TRACKER_POLL_IDLE_MAX_MS, UPDATE_TRACKER_POLL_HOLD);
+
+    for (;;) {
+        bool changed = false;
+
+        // The file may have been written before the watch was set up
+        if (read_file(&doc)) {
+            if (doc.fields & UPDATE_FIELD_PROGRESS) {
+                updating = doc.status.progress > 0 && doc.status.progress < 100;
+            }
+            queue_push(&doc);
+            changed = !doc.parse_error;
+        }
+
+        if (status_watch_is_active()) {
+            struct pollfd pfd = { .fd = status_watch_get_fd(), .events = POLLIN };
+            // When the watcher shuts down, read once more and go on polling
+            do {
+                poll(&pfd, 1, -1);
+            } while (!status_watch_process() && status_watch_is_active());
+        } else {
+            uint32_t interval = poll_sched_next(&sched, changed, updating);
+            usleep(interval * 1000);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Set up the watch and start the thread
+ */
+bool ingest_thread_start(const char *path, ingest_read_cb_t read_cb)
+{
+    if (active) {
+        return true;
+    }
+
+    if (pipe(wake_fds) != 0) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Cannot create the ingest pipe (%s)\n", strerror(errno));
+        return false;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(wake_fds[i], F_SETFL, fcntl(wake_fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(wake_fds[i], F_SETFD, FD_CLOEXEC);
+    }
+
+    if (status_watch_init(path)) {
+        TRACKER_LOG(TRACKER_LOG_INFO, "Update tracker: Watching for changes with inotify\n");
+    }
+
+    read_file = read_cb;
+    if (pthread_create(&thread, NULL, ingest_main, NULL) != 0) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Cannot start the ingest thread\n");
+        status_watch_deinit();
+        close(wake_fds[0]);
+        close(wake_fds[1]);
+        wake_fds[0] = wake_fds[1] = -1;
+        return false;
+    }
+    pthread_detach(thread);
+
+    active = true;
+    return true;
+}
+
+bool ingest_thread_is_active(void)
+{
+    return active;
+}
+
+int ingest_thread_get_fd(void)
+{
+    return wake_fds[0];
+}
+
+/**
+ * Take the oldest ready document
+ */
+bool ingest_thread_receive(ingest_doc_t *doc)
+{
+    unsigned int tail = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+    char drain[64];
+
+    if (!active) {
+        return false;
+    }
+
+    if (atomic_load_explicit(&queue_head, memory_order_acquire) == tail) {
+        // Empty: clear the wakeups, then look again for a push that raced with us
+        while (read(wake_fds[0], drain, sizeof(drain)) > 0) {
+        }
+        if (atomic_load_explicit(&queue_head, memory_order_acquire) == tail) {
+            return false;
+        }
+    }
+
+    *doc = queue[tail & QUEUE_MASK];
+    atomic_store_explicit(&queue_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+#else /* UPDATE_TRACKER_USE_INGEST_THREAD */
+
+/* No threads: the LVGL thread reads the status file in its timer */
+
+bool ingest_thread_start(const char *path, ingest_read_cb_t read_cb)
+{
+    (void)path;
+    (void)read_cb;
+    return false;
+}
+
+bool ingest_thread_is_active(void)
+{
+    return false;
+}
+
+int ingest_thread_get_fd(void)
+{
+    return -1;
+}
+
+bool ingest_thread_receive(ingest_doc_t *doc)
+{
+    (void)doc;
+    return false;
+}
+
+#endif /* UPDATE_TRACKER_USE_INGEST_THREAD */
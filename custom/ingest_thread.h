@@ -0,0 +1,79 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * ingest_thread - watching, reading and parsing the status file on a thread
+ * of its own, so a slow filesystem never stalls a frame.
+ * Parsed documents are handed to the LVGL thread through a lock-free single
+ * producer, single consumer queue. A pipe becomes readable when documents
+ * are ready, for the main loop to wait on.
+ */
+
+#ifndef INGEST_THREAD_H_
+#define INGEST_THREAD_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* One document read from the status file */
+typedef struct {
+    update_status_t status;     // decoded keys, the others are zero
+    uint32_t fields;            // UPDATE_FIELD_* bits of the decoded keys
+    uint64_t parse_us;          // time spent decoding
+    int64_t mtime_ns;           // modification time of the file, wall clock
+    bool parse_error;           // the file was malformed, nothing else is set
+} ingest_doc_t;
+
+/**
+ * Read the status file if it changed, called on the ingest thread
+ * @return true if doc holds a new document or a parse error
+ */
+typedef bool (*ingest_read_cb_t)(ingest_doc_t *doc);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Start the thread. It watches path with inotify where available and polls
+ * it on an adaptive interval otherwise.
+ * @param path status file, watched for changes
+ * @param read_cb reads the file, only ever called from the ingest thread
+ * @return true if the thread runs, false if the caller has to read the file itself
+ */
+bool ingest_thread_start(const char *path, ingest_read_cb_t read_cb);
+
+/**
+ * @return true while the ingest thread owns the status file
+ */
+bool ingest_thread_is_active(void);
+
+/**
+ * Get the descriptor that becomes readable when documents are ready
+ * @return file descriptor or -1 if the thread does not run
+ */
+int ingest_thread_get_fd(void);
+
+/**
+ * Take the oldest ready document without blocking, from the LVGL thread
+ * @return false if no document is ready
+ */
+bool ingest_thread_receive(ingest_doc_t *doc);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* INGEST_THREAD_H_ */
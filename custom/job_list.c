@@ -0,0 +1,240 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "../generated/update_tracker.h"
+#include "job_list.h"
+#include "status_jobs.h"
+#include "tracker_conf.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ID_WIDTH        260
+#define STATUS_WIDTH    330
+#define BAR_HEIGHT      16
+#define COLUMN_GAP      10
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* One instantiated row, bound to whichever job is scrolled into its slot */
+typedef struct {
+    lv_obj_t *obj;
+    lv_obj_t *id_label;
+    lv_obj_t *bar;
+    lv_obj_t *status_label;
+    int32_t job_idx;                // -1 while the row is unused
+    uint32_t job_version;
+    char job_id[UPDATE_STATUS_ID_LEN];
+#if UPDATE_TRACKER_STATIC_LABELS
+    char status_text[UPDATE_STATUS_TEXT_LEN + 8];   // shown by status_label, id_label shows job_id
+#endif
+} job_row_t;
+
+typedef struct {
+    lv_obj_t *spacer;               // last pixel of the content, sets the scroll range
+    job_row_t rows[JOB_LIST_MAX_ROWS];
+    uint32_t row_cnt;
+} job_list_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_style_t style_plain;      // shared by every row, no per object styles
+static lv_style_t style_text;
+static lv_style_t style_bar;
+static lv_style_t style_indicator;
+static bool styles_ready = false;
+
+static void init_styles(void)
+{
+    if (styles_ready) {
+        return;
+    }
+    lv_style_init(&style_plain);
+    lv_style_set_bg_opa(&style_plain, LV_OPA_TRANSP);
+    lv_style_set_border_width(&style_plain, 0);
+    lv_style_set_pad_all(&style_plain, 0);
+    lv_style_set_radius(&style_plain, 0);
+
+    lv_style_init(&style_text);
+    lv_style_set_text_color(&style_text, lv_color_hex(0xffffff));
+    lv_style_set_text_font(&style_text, &lv_font_montserratMedium_24);
+
+    lv_style_init(&style_bar);
+    lv_style_set_bg_color(&style_bar, lv_color_hex(0x83aab8));
+    lv_style_set_bg_opa(&style_bar, LV_OPA_30);
+    lv_style_set_radius(&style_bar, BAR_HEIGHT / 2);
+
+    lv_style_init(&style_indicator);
+    lv_style_set_bg_color(&style_indicator, lv_color_hex(0x27555b));
+    lv_style_set_bg_opa(&style_indicator, LV_OPA_COVER);
+    lv_style_set_radius(&style_indicator, BAR_HEIGHT / 2);
+    styles_ready = true;
+}
+
+static lv_obj_t *create_label(lv_obj_t *parent, int32_t x, int32_t w)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_add_style(label, &style_text, LV_PART_MAIN);
+    lv_obj_set_pos(label, x, 0);
+    // One line high, so a long text ends in "..." instead of wrapping out of the row
+    lv_obj_set_size(label, w, lv_font_get_line_height(&lv_font_montserratMedium_24));
+    lv_obj_set_align(label, LV_ALIGN_LEFT_MID);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);
+    lv_label_set_text_static(label, "");
+    return label;
+}
+
+static void create_row(lv_obj_t *list, job_row_t *row, int32_t w)
+{
+    row->obj = lv_obj_create(list);
+    lv_obj_remove_style_all(row->obj);
+    lv_obj_add_style(row->obj, &style_plain, LV_PART_MAIN);
+    lv_obj_set_size(row->obj, w, JOB_LIST_ROW_HEIGHT);
+    // Presses go through to the list so dragging a row scrolls it
+    lv_obj_remove_flag(row->obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(row->obj, LV_OBJ_FLAG_HIDDEN);
+
+    row->id_label = create_label(row->obj, 0, ID_WIDTH);
+    row->bar = lv_bar_create(row->obj);
+    lv_obj_add_style(row->bar, &style_bar, LV_PART_MAIN);
+    lv_obj_add_style(row->bar, &style_indicator, LV_PART_INDICATOR);
+    lv_obj_set_pos(row->bar, ID_WIDTH + COLUMN_GAP, 0);
+    lv_obj_set_size(row->bar, w - ID_WIDTH - STATUS_WIDTH - 2 * COLUMN_GAP, BAR_HEIGHT);
+    lv_obj_set_align(row->bar, LV_ALIGN_LEFT_MID);
+    lv_obj_remove_flag(row->bar, LV_OBJ_FLAG_CLICKABLE);
+    lv_bar_set_range(row->bar, 0, 100);
+    row->status_label = create_label(row->obj, w - STATUS_WIDTH, STATUS_WIDTH);
+
+    row->job_idx = -1;
+}
+
+/**
+ * Show a job in a row
+ */
+static void bind_row(job_row_t *row, int32_t idx, const status_job_t *job)
+{
+    if (row->job_idx != idx) {
+        lv_obj_set_y(row->obj, idx * JOB_LIST_ROW_HEIGHT);
+        lv_obj_remove_flag(row->obj, LV_OBJ_FLAG_HIDDEN);
+    }
+    lv_bar_set_value(row->bar, job->status.progress, LV_ANIM_OFF);
+    memcpy(row->job_id, job->status.id, sizeof(row->job_id));
+#if UPDATE_TRACKER_STATIC_LABELS
+    // The rows are recycled while scrolling, their texts stay in the row and off the LVGL heap
+    snprintf(row->status_text, sizeof(row->status_text), "%d%% %s", job->status.progress, job->status.status);
+    lv_label_set_text_static(row->id_label, row->job_id);
+    lv_label_set_text_static(row->status_label, row->status_text);
+#else
+    char text[UPDATE_STATUS_TEXT_LEN + 8];
+    snprintf(text, sizeof(text), "%d%% %s", job->status.progress, job->status.status);
+    lv_label_set_text(row->id_label, job->status.id);
+    lv_label_set_text(row->status_label, text);
+#endif
+
+    row->job_idx = idx;
+    row->job_version = job->version;
+}
+
+/**
+ * Bind the visible jobs to the rows. A job keeps the slot idx % row_cnt, so
+ * the rows still visible after a scroll are left as they are.
+ */
+static void bind_visible(lv_obj_t *list, job_list_t *jl)
+{
+    int32_t first = LV_MAX(0, lv_obj_get_scroll_y(list) / JOB_LIST_ROW_HEIGHT);
+
+    for (uint32_t i = 0; i < jl->row_cnt; i++) {
+        int32_t idx = first + (int32_t)i;
+        job_row_t *row = &jl->rows[(uint32_t)idx % jl->row_cnt];
+        const status_job_t *job = status_jobs_get((uint32_t)idx);
+
+        if (job == NULL) {
+            if (row->job_idx >= 0) {
+                lv_obj_add_flag(row->obj, LV_OBJ_FLAG_HIDDEN);
+                row->job_idx = -1;
+            }
+            continue;
+        }
+        // The same index can hold another job after an insertion or a removal
+        if (row->job_idx != idx || row->job_version != job->version || strcmp(row->job_id, job->status.id) != 0) {
+            bind_row(row, idx, job);
+        }
+    }
+}
+
+static void list_scroll_cb(lv_event_t *e)
+{
+    lv_obj_t *list = lv_event_get_target(e);
+    bind_visible(list, lv_obj_get_user_data(list));
+}
+
+static void list_delete_cb(lv_event_t *e)
+{
+    lv_obj_t *list = lv_event_get_target(e);
+    lv_free(lv_obj_get_user_data(list));
+}
+
+lv_obj_t *job_list_create(lv_obj_t *parent, int32_t w, int32_t h)
+{
+    job_list_t *jl = lv_malloc_zeroed(sizeof(job_list_t));
+    lv_obj_t *list;
+
+    if (jl == NULL) {
+        return NULL;
+    }
+    init_styles();
+
+    list = lv_obj_create(parent);
+    lv_obj_remove_style_all(list);
+    lv_obj_add_style(list, &style_plain, LV_PART_MAIN);
+    lv_obj_set_size(list, w, h);
+    lv_obj_set_scroll_dir(list, LV_DIR_VER);
+    lv_obj_set_scrollbar_mode(list, LV_SCROLLBAR_MODE_AUTO);
+    lv_obj_set_user_data(list, jl);
+
+    jl->spacer = lv_obj_create(list);
+    lv_obj_remove_style_all(jl->spacer);
+    lv_obj_set_size(jl->spacer, 1, 1);
+    lv_obj_remove_flag(jl->spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(jl->spacer, LV_OBJ_FLAG_HIDDEN);
+
+    // One row more than fits, for the partly visible rows while scrolling
+    jl->row_cnt = LV_MIN((uint32_t)((h + JOB_LIST_ROW_HEIGHT - 1) / JOB_LIST_ROW_HEIGHT) + 1, JOB_LIST_MAX_ROWS);
+    for (uint32_t i = 0; i < jl->row_cnt; i++) {
+        create_row(list, &jl->rows[i], w);
+    }
+
+    lv_obj_add_event_cb(list, list_scroll_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(list, list_delete_cb, LV_EVENT_DELETE, NULL);
+    job_list_refresh(list);
+    return list;
+}
+
+void job_list_refresh(lv_obj_t *list)
+{
+    job_list_t *jl = lv_obj_get_user_data(list);
+    uint32_t count = status_jobs_get_count();
+
+    // The scroll range covers every job, though only the visible ones have objects
+    if (count > 0) {
+        lv_obj_set_y(jl->spacer, (int32_t)count * JOB_LIST_ROW_HEIGHT - 1);
+        lv_obj_remove_flag(jl->spacer, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(jl->spacer, LV_OBJ_FLAG_HIDDEN);
+    }
+    bind_visible(list, jl);
+}
@@ -0,0 +1,48 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+#ifndef JOB_LIST_H_
+#define JOB_LIST_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define JOB_LIST_ROW_HEIGHT 40
+#define JOB_LIST_MAX_ROWS   24      // rows instantiated at most, whatever the number of jobs
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Create a scrollable list of the jobs of status_jobs.
+ * Only the rows that fit the list's height (plus one for scrolling) are
+ * created. Scrolling moves them and binds them to other jobs, so objects and
+ * redraws follow the visible rows, not the number of jobs.
+ * @param parent    parent of the list
+ * @param w         width of the list
+ * @param h         height of the list
+ */
+lv_obj_t *job_list_create(lv_obj_t *parent, int32_t w, int32_t h);
+
+/**
+ * Show the current jobs, after status_jobs changed.
+ * Only the visible rows whose job changed are touched.
+ */
+void job_list_refresh(lv_obj_t *list);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* JOB_LIST_H_ */
@@ -31,6 +31,11 @@
 /* code for simulator end */
 #else
 /* code for board begin */
+/* i.MX 2D engine (GPU2D, DPU or PXP through libg2d) as draw unit, opt in with -DUPDATE_TRACKER_DRAW_G2D=1 */
+#if defined(UPDATE_TRACKER_DRAW_G2D) && UPDATE_TRACKER_DRAW_G2D
+#undef LV_USE_DRAW_G2D
+#define LV_USE_DRAW_G2D 1
+#endif
 
 
 /* code for board end */	
@@ -0,0 +1,48 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "poll_sched.h"
+
+void poll_sched_init(poll_sched_t *sched, uint32_t fast_ms, uint32_t active_max_ms, uint32_t idle_max_ms,
+                     uint32_t hold_polls)
+{
+    sched->fast_ms = fast_ms;
+    sched->active_max_ms = active_max_ms < fast_ms ? fast_ms : active_max_ms;
+    sched->idle_max_ms = idle_max_ms < sched->active_max_ms ? sched->active_max_ms : idle_max_ms;
+    sched->hold_polls = hold_polls;
+    sched->interval_ms = fast_ms;
+    sched->quiet_polls = 0;
+}
+
+uint32_t poll_sched_next(poll_sched_t *sched, bool changed, bool active)
+{
+    uint32_t ceiling = active ? sched->active_max_ms : sched->idle_max_ms;
+
+    if (changed) {
+        // Progress is moving or the step changed: the next change is likely soon
+        sched->quiet_polls = 0;
+        sched->interval_ms = sched->fast_ms;
+        return sched->interval_ms;
+    }
+
+    if (sched->quiet_polls < sched->hold_polls) {
+        sched->quiet_polls++;
+    } else if (sched->interval_ms < ceiling) {
+        sched->interval_ms = sched->interval_ms > ceiling / 2 ? ceiling : sched->interval_ms * 2;
+    }
+    // An update that just finished leaves a lower interval than the idle ceiling, an update that starts a higher one
+    if (sched->interval_ms > ceiling) {
+        sched->interval_ms = ceiling;
+    }
+    return sched->interval_ms;
+}
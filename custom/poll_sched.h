@@ -0,0 +1,55 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * poll_sched - polling interval of the status file when no change
+ * notification is available. Polls fast while the status changes and backs
+ * off exponentially while it does not.
+ */
+
+#ifndef POLL_SCHED_H_
+#define POLL_SCHED_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t fast_ms;           // interval right after a change
+    uint32_t active_max_ms;     // ceiling while an update is running
+    uint32_t idle_max_ms;       // ceiling while no update is running
+    uint32_t hold_polls;        // polls kept fast after a change
+    uint32_t interval_ms;       // current interval
+    uint32_t quiet_polls;       // polls without a change since the last one
+} poll_sched_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void poll_sched_init(poll_sched_t *sched, uint32_t fast_ms, uint32_t active_max_ms, uint32_t idle_max_ms,
+                     uint32_t hold_polls);
+
+/**
+ * Account for one poll and get the interval until the next one
+ * @param changed   the poll found a new status
+ * @param active    an update is running, which caps the back-off lower
+ * @return interval in ms
+ */
+uint32_t poll_sched_next(poll_sched_t *sched, bool changed, bool active);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* POLL_SCHED_H_ */
@@ -0,0 +1,203 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tracker_conf.h"
+#include "progress_engine.h"
+
+#if UPDATE_TRACKER_USE_PROGRESS_ENGINE && LV_VERSION_CHECK(9, 2, 0)
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SUBSTEPS        10      // bar steps per percent, about one pixel on the 734 px bar
+#define PROGRESS_MAX    (100 * SUBSTEPS)
+#define RATE_WEIGHT     0.3f    // weight of the newest interval in the rate average
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_obj_t *engine_bar;
+static lv_timer_t *frame_timer;
+static int32_t sample_value = 0;    // last reported progress, in steps
+static uint32_t sample_ms = 0;      // tick of the last sample
+static bool sample_valid = false;
+static float rate = 0.0f;           // steps per ms, 0 until two samples are known
+static uint32_t frame_ms = 0;       // tick of the last frame
+
+/**
+ * X coordinate of the end of the indicator for a value
+ */
+static int32_t fill_end(lv_obj_t *obj, int32_t value)
+{
+    lv_area_t coords;
+    int32_t x1;
+    int32_t w = lv_obj_get_width(obj) - lv_obj_get_style_pad_left(obj, LV_PART_MAIN) -
+                lv_obj_get_style_pad_right(obj, LV_PART_MAIN);
+    int32_t min = lv_bar_get_min_value(obj);
+    int32_t range = lv_bar_get_max_value(obj) - min;
+
+    lv_obj_get_coords(obj, &coords);
+    x1 = coords.x1 + lv_obj_get_style_pad_left(obj, LV_PART_MAIN);
+    return x1 + (int32_t)((int64_t)w * (value - min) / (range > 0 ? range : 1));
+}
+
+/**
+ * Move the indicator and invalidate only the strip it gained or lost
+ */
+static void bar_show(int32_t value)
+{
+    lv_display_t *disp = lv_obj_get_display(engine_bar);
+    int32_t radius = lv_obj_get_style_radius(engine_bar, LV_PART_INDICATOR);
+    int32_t shown = lv_bar_get_value(engine_bar);
+    int32_t old_end, new_end;
+    lv_area_t coords;
+    lv_area_t strip;
+
+    if (value == shown) {
+        return;
+    }
+    old_end = fill_end(engine_bar, shown);
+    new_end = fill_end(engine_bar, value);
+
+    // lv_bar_set_value() invalidates the whole bar, hold that back and invalidate the strip below
+    lv_display_enable_invalidation(disp, false);
+    lv_bar_set_value(engine_bar, value, LV_ANIM_OFF);
+    lv_display_enable_invalidation(disp, true);
+
+    // The rounded end moves with the value: widen the strip by the radius on both sides
+    strip.x1 = LV_MIN(old_end, new_end) - radius;
+    strip.x2 = LV_MAX(old_end, new_end) + radius;
+    lv_obj_get_coords(engine_bar, &coords);
+    strip.y1 = coords.y1;
+    strip.y2 = coords.y2;
+    // A short indicator shrinks its radius, which reshapes its start as well
+    if (strip.x1 - coords.x1 < 2 * radius) {
+        strip.x1 = coords.x1;
+    }
+    lv_obj_invalidate_area(engine_bar, &strip);
+}
+
+/**
+ * Where the bar should be now: the last sample extrapolated with the measured
+ * rate, but never past the next percent, which has not been reported yet
+ */
+static int32_t target_value(uint32_t now)
+{
+    int32_t target = sample_value;
+
+    if (rate > 0.0f) {
+        target += (int32_t)(rate * (float)lv_tick_diff(now, sample_ms));
+        target = LV_MIN(target, LV_MIN(sample_value + SUBSTEPS - 1, PROGRESS_MAX));
+    }
+    return target;
+}
+
+static void frame_timer_cb(lv_timer_t *timer)
+{
+    uint32_t now = lv_tick_get();
+    uint32_t elapsed = lv_tick_diff(now, frame_ms);
+    int32_t shown = lv_bar_get_value(engine_bar);
+    int32_t target = target_value(now);
+    int32_t step;
+
+    frame_ms = now;
+
+    // Ease towards the target: far behind moves fast, close moves gently
+    step = (int32_t)((int64_t)(target - shown) * (int32_t)LV_MIN(elapsed, (uint32_t)PROGRESS_ENGINE_EASE_MS) /
+                     PROGRESS_ENGINE_EASE_MS);
+    if (step == 0 && target != shown) {
+        step = target > shown ? 1 : -1;
+    }
+    bar_show(shown + step);
+
+    // Nothing left to move until the next sample
+    if (shown + step == target && (rate == 0.0f || target == LV_MIN(sample_value + SUBSTEPS - 1, PROGRESS_MAX))) {
+        lv_timer_pause(timer);
+    }
+}
+
+void progress_engine_init(lv_obj_t *bar, int32_t progress)
+{
+    engine_bar = bar;
+    lv_bar_set_range(bar, 0, PROGRESS_MAX);
+    lv_bar_set_value(bar, progress * SUBSTEPS, LV_ANIM_OFF);
+
+    sample_value = progress * SUBSTEPS;
+    sample_valid = false;
+    rate = 0.0f;
+    frame_timer = lv_timer_create(frame_timer_cb, 1000 / PROGRESS_ENGINE_FPS, NULL);
+    lv_timer_pause(frame_timer);
+}
+
+void progress_engine_set(int32_t progress)
+{
+    uint32_t now = lv_tick_get();
+    int32_t value = LV_CLAMP(0, progress, 100) * SUBSTEPS;
+
+    if (engine_bar == NULL) {
+        return;
+    }
+
+    if (!sample_valid || value < sample_value) {
+        // First sample or a new update started: no rate to extrapolate with yet
+        rate = 0.0f;
+    } else if (value > sample_value && lv_tick_diff(now, sample_ms) > 0) {
+        float interval_rate = (float)(value - sample_value) / (float)lv_tick_diff(now, sample_ms);
+        rate = rate == 0.0f ? interval_rate : rate + RATE_WEIGHT * (interval_rate - rate);
+    }
+    if (value == PROGRESS_MAX) {
+        rate = 0.0f;
+    }
+    sample_value = value;
+    sample_ms = now;
+    sample_valid = true;
+
+    if (lv_timer_get_paused(frame_timer)) {
+        frame_ms = now;
+        lv_timer_resume(frame_timer);
+    }
+}
+
+int32_t progress_engine_get_eta(void)
+{
+    if (rate <= 0.0f) {
+        return -1;
+    }
+    return (int32_t)((float)(PROGRESS_MAX - sample_value) / rate / 1000.0f);
+}
+
+#else /* UPDATE_TRACKER_USE_PROGRESS_ENGINE && LV_VERSION_CHECK(9, 2, 0) */
+
+/* Plain bar: every update runs the style's animation towards the new value */
+
+static lv_obj_t *engine_bar;
+
+void progress_engine_init(lv_obj_t *bar, int32_t progress)
+{
+    engine_bar = bar;
+    lv_bar_set_value(bar, progress, LV_ANIM_OFF);
+}
+
+void progress_engine_set(int32_t progress)
+{
+    if (engine_bar != NULL) {
+        lv_bar_set_value(engine_bar, progress, LV_ANIM_ON);
+    }
+}
+
+int32_t progress_engine_get_eta(void)
+{
+    return -1;
+}
+
+#endif /* UPDATE_TRACKER_USE_PROGRESS_ENGINE && LV_VERSION_CHECK(9, 2, 0) */
@@ -0,0 +1,48 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+#ifndef PROGRESS_ENGINE_H_
+#define PROGRESS_ENGINE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Drive a 0..100 bar from progress samples instead of restarting its animation
+ * on every update. The bar follows the rate measured between samples, at a
+ * capped frame rate, and only the strip between the old and the new end of
+ * the indicator is redrawn.
+ * @param bar       the bar, its range is changed to sub-percent steps
+ * @param progress  value shown at start, 0..100
+ */
+void progress_engine_init(lv_obj_t *bar, int32_t progress);
+
+/**
+ * Feed a new progress sample, timestamped now
+ * @param progress  reported progress, 0..100, a lower value restarts the estimate
+ */
+void progress_engine_set(int32_t progress);
+
+/**
+ * Get the remaining time estimated from the measured rate
+ * @return seconds, -1 until the rate is known
+ */
+int32_t progress_engine_get_eta(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PROGRESS_ENGINE_H_ */
@@ -0,0 +1,259 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "../generated/update_tracker.h"
+#include "tracker_conf.h"
+#include "startup.h"
+
+#if IS_ZEPHYR
+    #include <zephyr/kernel.h>
+#else
+    #include <time.h>
+    #if defined(__linux__)
+        #include <unistd.h>
+    #endif
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MAX_DEFERRED    4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char *stage;
+    uint64_t us;
+    uint32_t heap_used;     // LVGL heap in use, 0 when LVGL uses the system allocator
+} startup_mark_t;
+
+typedef struct {
+    startup_cb_t cb;
+    void *user_data;
+} deferred_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static startup_mark_t marks[STARTUP_MAX_MARKS];
+static uint32_t mark_cnt = 0;
+static bool reported = false;
+static deferred_t deferred[MAX_DEFERRED];
+static uint32_t deferred_cnt = 0;
+static lv_display_t *watched_disp;
+
+/**
+ * Time since boot, the clock the process start time is given in on Linux
+ */
+static uint64_t now_us(void)
+{
+#if IS_ZEPHYR
+    return k_ticks_to_us_floor64((uint64_t)k_uptime_ticks());
+#elif defined(_WIN32) || defined(_WIN64)
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+#elif defined(__linux__)
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * When the process started, on the now_us() clock
+ * @return false if unknown, the first mark is the origin then
+ */
+static bool process_start_us(uint64_t *start)
+{
+#if IS_ZEPHYR
+    // The application starts with the kernel
+    *start = 0;
+    return true;
+#elif defined(__linux__)
+    char stat[512];
+    unsigned long long start_ticks;
+    const char *p;
+    FILE *f = fopen("/proc/self/stat", "r");
+    size_t len;
+
+    if (f == NULL) {
+        return false;
+    }
+    len = fread(stat, 1, sizeof(stat) - 1, f);
+    fclose(f);
+    stat[len] = '\0';
+
+    // The command name may hold spaces, the fields are counted from its closing parenthesis
+    p = strrchr(stat, ')');
+    if (p == NULL) {
+        return false;
+    }
+    // starttime is field 22, it follows the 20th space after the parenthesis
+    for (int i = 0; i < 20 && p != NULL; i++) {
+        p = strchr(p + 1, ' ');
+    }
+    if (p == NULL || sscanf(p, " %llu", &start_ticks) != 1) {
+        return false;
+    }
+    *start = start_ticks * 1000000ULL / (uint64_t)sysconf(_SC_CLK_TCK);
+    return true;
+#else
+    LV_UNUSED(start);
+    return false;
+#endif
+}
+
+static void report(void)
+{
+    uint64_t origin;
+    bool from_start = process_start_us(&origin);
+
+    if (!from_start) {
+        origin = marks[0].us;
+    }
+
+    printf("Startup (ms since %s):", from_start ? "process start" : marks[0].stage);
+    for (uint32_t i = 0; i < mark_cnt; i++) {
+        printf(" %s %.1f", marks[i].stage, (double)(marks[i].us - origin) / 1000.0);
+        if (marks[i].heap_used > 0) {
+            printf(" (heap %u)", (unsigned)marks[i].heap_used);
+        }
+    }
+    printf("\n");
+}
+
+/**
+ * LVGL heap in use, only known with its built-in allocator
+ */
+static uint32_t heap_used(void)
+{
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return (uint32_t)(mon.total_size - mon.free_size);
+#else
+    return 0;
+#endif
+}
+
+void startup_mark(const char *stage)
+{
+    if (mark_cnt < STARTUP_MAX_MARKS) {
+        marks[mark_cnt].stage = stage;
+        marks[mark_cnt].us = now_us();
+        // lv_init() sets the heap up, an earlier mark only has the time
+        marks[mark_cnt].heap_used = lv_is_initialized() ? heap_used() : 0;
+        mark_cnt++;
+    }
+}
+
+static void deferred_timer_cb(lv_timer_t *timer)
+{
+    uint32_t cnt = deferred_cnt;
+
+    LV_UNUSED(timer);
+
+    deferred_cnt = 0;
+    for (uint32_t i = 0; i < cnt; i++) {
+        deferred[i].cb(deferred[i].user_data);
+    }
+    if (!reported) {
+        startup_mark("deferred_work");
+        report();
+        reported = true;
+    }
+}
+
+/**
+ * The first frame is out: stop listening and run the deferred work outside the refresh
+ */
+static void first_frame_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+
+    if (watched_disp == NULL) {
+        return;
+    }
+    watched_disp = NULL;
+    startup_mark("first_frame");
+    lv_timer_set_repeat_count(lv_timer_create(deferred_timer_cb, 0, NULL), 1);
+}
+
+void startup_after_first_frame(lv_display_t *disp, startup_cb_t cb, void *user_data)
+{
+    if (deferred_cnt >= MAX_DEFERRED) {
+        cb(user_data);
+        return;
+    }
+    deferred[deferred_cnt].cb = cb;
+    deferred[deferred_cnt].user_data = user_data;
+    deferred_cnt++;
+
+    if (disp == NULL) {
+        lv_timer_set_repeat_count(lv_timer_create(deferred_timer_cb, 0, NULL), 1);
+    } else if (watched_disp == NULL && !reported) {
+        watched_disp = disp;
+        lv_display_add_event_cb(disp, first_frame_cb, LV_EVENT_REFR_READY, NULL);
+    } else if (reported) {
+        lv_timer_set_repeat_count(lv_timer_create(deferred_timer_cb, 0, NULL), 1);
+    }
+}
+
+#if UPDATE_TRACKER_USE_SPLASH
+
+static lv_obj_t *splash_screen;
+
+void startup_show_splash(void)
+{
+    lv_obj_t *logo;
+
+    // Same background and logo position as the update screen, so loading it over the splash only adds the text and the bar
+    splash_screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(splash_screen, lv_color_hex(0x191919), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(splash_screen, LV_OPA_COVER, LV_PART_MAIN);
+    logo = lv_image_create(splash_screen);
+    lv_image_set_src(logo, &_Stratus_RGB565A8_891x120);
+    lv_obj_set_pos(logo, 194, 107);
+    lv_screen_load(splash_screen);
+
+    lv_refr_now(NULL);
+    startup_mark("splash");
+}
+
+void startup_release_splash(void)
+{
+    if (splash_screen != NULL && splash_screen != lv_screen_active()) {
+        lv_obj_delete(splash_screen);
+        splash_screen = NULL;
+    }
+}
+
+#else /* UPDATE_TRACKER_USE_SPLASH */
+
+void startup_show_splash(void)
+{
+}
+
+void startup_release_splash(void)
+{
+}
+
+#endif /* UPDATE_TRACKER_USE_SPLASH */
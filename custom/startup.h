@@ -0,0 +1,65 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * startup - time to first frame. Records when each startup stage ends,
+ * shows a splash built from already compiled-in pixels while the UI is
+ * created, and runs non-critical work only once the first frame is out.
+ */
+
+#ifndef STARTUP_H_
+#define STARTUP_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define STARTUP_MAX_MARKS   16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef void (*startup_cb_t)(void *user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Record the end of a startup stage, with the LVGL heap in use. The report is
+ * printed once the work deferred past the first frame has run.
+ * @param stage     name of the stage, must stay valid
+ */
+void startup_mark(const char *stage);
+
+/**
+ * Show the splash: the background and the logo of the update screen, flushed
+ * right away. Call before setup_ui(), which loads the real screen over it.
+ */
+void startup_show_splash(void);
+
+/**
+ * Delete the splash once the real screen is loaded
+ */
+void startup_release_splash(void);
+
+/**
+ * Run a callback once, from a timer, after the first frame of a display is
+ * flushed. Without a display it runs on the next timer pass.
+ */
+void startup_after_first_frame(lv_display_t *disp, startup_cb_t cb, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STARTUP_H_ */
@@ -0,0 +1,149 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tracker_conf.h"
+#include "tracker_log.h"
+#include "static_layer.h"
+
+#if UPDATE_TRACKER_USE_STATIC_LAYER && LV_USE_SNAPSHOT
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MAX_STATIC_OBJS      8
+#define MAX_SCREEN_CHILDREN  64
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_obj_t *layer_screen;
+static lv_draw_buf_t *layer_buf;
+static lv_obj_t *layer_objs[MAX_STATIC_OBJS];
+static uint32_t layer_obj_cnt = 0;
+
+static bool is_static(lv_obj_t *obj, lv_obj_t *const *static_objs, uint32_t cnt)
+{
+    for (uint32_t i = 0; i < cnt; i++) {
+        if (static_objs[i] == obj) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Hide or show the children that are not part of the layer
+ * @param hidden    per child: was it hidden before baking (restored on show)
+ */
+static void set_dynamic_hidden(lv_obj_t *screen, lv_obj_t *const *static_objs, uint32_t cnt, bool hide, bool *hidden)
+{
+    uint32_t child_cnt = lv_obj_get_child_count(screen);
+
+    for (uint32_t i = 0; i < child_cnt && i < MAX_SCREEN_CHILDREN; i++) {
+        lv_obj_t *child = lv_obj_get_child(screen, (int32_t)i);
+        if (is_static(child, static_objs, cnt)) {
+            continue;
+        }
+        if (hide) {
+            hidden[i] = lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_add_flag(child, LV_OBJ_FLAG_HIDDEN);
+        } else if (!hidden[i]) {
+            lv_obj_remove_flag(child, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+static void screen_delete_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    // The widgets go away with the screen, only the image is left to free
+    layer_obj_cnt = 0;
+    layer_screen = NULL;
+    static_layer_release();
+}
+
+bool static_layer_bake(lv_obj_t *screen, lv_obj_t *const *static_objs, uint32_t cnt)
+{
+    bool hidden[MAX_SCREEN_CHILDREN];
+    lv_color_format_t cf = lv_display_get_color_format(lv_obj_get_display(screen));
+
+    if (cnt > MAX_STATIC_OBJS || lv_obj_get_child_count(screen) > MAX_SCREEN_CHILDREN) {
+        return false;
+    }
+    static_layer_release();
+
+    // Same format as the display: drawing the layer is a plain copy, no conversion
+    set_dynamic_hidden(screen, static_objs, cnt, true, hidden);
+    layer_buf = lv_snapshot_take(screen, cf);
+    set_dynamic_hidden(screen, static_objs, cnt, false, hidden);
+
+    if (layer_buf == NULL) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Warning: No memory for the static layer, drawing the widgets directly\n");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < cnt; i++) {
+        layer_objs[i] = static_objs[i];
+        lv_obj_add_flag(static_objs[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    layer_obj_cnt = cnt;
+
+    // The snapshot has the screen's size, so the centered background image covers it exactly
+    lv_obj_set_style_bg_image_src(screen, layer_buf, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_image_opa(screen, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_image_tiled(screen, false, LV_PART_MAIN | LV_STATE_DEFAULT);
+    if (layer_screen != screen) {
+        lv_obj_add_event_cb(screen, screen_delete_cb, LV_EVENT_DELETE, NULL);
+    }
+    layer_screen = screen;
+
+    TRACKER_LOG(TRACKER_LOG_INFO, "Static layer: %u objects baked into a %ux%u image (%u bytes)\n", (unsigned)cnt,
+                (unsigned)layer_buf->header.w, (unsigned)layer_buf->header.h, (unsigned)layer_buf->data_size);
+    return true;
+}
+
+void static_layer_release(void)
+{
+    for (uint32_t i = 0; i < layer_obj_cnt; i++) {
+        lv_obj_remove_flag(layer_objs[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    layer_obj_cnt = 0;
+
+    if (layer_screen != NULL) {
+        lv_obj_set_style_bg_image_src(layer_screen, NULL, LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+    if (layer_buf != NULL) {
+        // Drop any cache entry that still points at the pixels
+        lv_image_cache_drop(layer_buf);
+        lv_draw_buf_destroy(layer_buf);
+        layer_buf = NULL;
+    }
+}
+
+#else /* UPDATE_TRACKER_USE_STATIC_LAYER && LV_USE_SNAPSHOT */
+
+/* No snapshot support: the static widgets are drawn on every refresh */
+
+bool static_layer_bake(lv_obj_t *screen, lv_obj_t *const *static_objs, uint32_t cnt)
+{
+    LV_UNUSED(screen);
+    LV_UNUSED(static_objs);
+    LV_UNUSED(cnt);
+    return false;
+}
+
+void static_layer_release(void)
+{
+}
+
+#endif /* UPDATE_TRACKER_USE_STATIC_LAYER && LV_USE_SNAPSHOT */
@@ -0,0 +1,41 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+#ifndef STATIC_LAYER_H_
+#define STATIC_LAYER_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+/**
+ * Render the screen once with only the given static children visible and use
+ * the result as the screen's background image. The static children are then
+ * hidden, so a full refresh draws them with a single opaque image blit.
+ * @param screen      screen to bake, its layout must be up to date
+ * @param static_objs children of the screen that never change
+ * @param cnt         number of entries in static_objs
+ * @return false if the layer is disabled or could not be allocated; the
+ *         screen is left untouched then
+ */
+bool static_layer_bake(lv_obj_t *screen, lv_obj_t *const *static_objs, uint32_t cnt);
+
+/**
+ * Show the static children again and free the cached image
+ */
+void static_layer_release(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATIC_LAYER_H_ */
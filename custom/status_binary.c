@@ -0,0 +1,244 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "tracker_conf.h"
+#include "status_binary.h"
+
+#if UPDATE_TRACKER_USE_BINARY
+    #include <fcntl.h>
+    #include <stdatomic.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CRC_START   offsetof(status_record_t, progress)
+#define CRC_LEN     (offsetof(status_record_t, crc) - CRC_START)
+
+_Static_assert(sizeof(status_record_t) == 272, "the record layout is shared with tools/status_bin.py");
+_Static_assert(offsetof(status_record_t, bytes_done) == 24, "the record layout is shared with tools/status_bin.py");
+_Static_assert(offsetof(status_record_t, crc) == 264, "the record layout is shared with tools/status_bin.py");
+
+/**
+ * CRC-32 with a 16 entry table, the record is small and changes rarely
+ */
+uint32_t status_binary_crc32(const void *data, uint32_t len)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    const uint8_t *p = data;
+    uint32_t crc = 0xffffffffu;
+
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+    }
+    return ~crc;
+}
+
+#if UPDATE_TRACKER_USE_BINARY
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static status_record_t *record = NULL;  // shared mapping of the file
+static uint32_t last_seq = 1;           // odd, never matches a complete record
+
+static _Atomic uint32_t *record_seq(status_record_t *r)
+{
+    return (_Atomic uint32_t *)&r->seq;
+}
+
+/**
+ * Map the record read only
+ */
+bool status_binary_open(const char *path)
+{
+    struct stat st;
+    void *map;
+    int fd;
+
+    if (record != NULL) {
+        return true;
+    }
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(status_record_t)) {
+        close(fd);
+        return false;
+    }
+    map = mmap(NULL, sizeof(status_record_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the file
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    record = map;
+    last_seq = 1;
+    return true;
+}
+
+/**
+ * Copy the record out under the sequence lock
+ */
+status_binary_result_t status_binary_read(update_status_t *status)
+{
+    status_record_t copy;
+    uint32_t seq;
+
+    if (record == NULL) {
+        return STATUS_BINARY_INVALID;
+    }
+
+    seq = atomic_load_explicit(record_seq(record), memory_order_acquire);
+    if (seq == last_seq) {
+        return STATUS_BINARY_UNCHANGED;
+    }
+    if (seq & 1) {
+        return STATUS_BINARY_TORN;
+    }
+
+    memcpy(&copy, record, sizeof(copy));
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(record_seq(record), memory_order_relaxed) != seq) {
+        return STATUS_BINARY_TORN;
+    }
+
+    if (copy.magic != STATUS_BINARY_MAGIC || copy.version != STATUS_BINARY_VERSION ||
+        copy.size != sizeof(status_record_t)) {
+        return STATUS_BINARY_INVALID;
+    }
+    // A producer that skipped the sequence lock can still tear the record
+    if (status_binary_crc32((const uint8_t *)&copy + CRC_START, CRC_LEN) != copy.crc) {
+        return STATUS_BINARY_TORN;
+    }
+    last_seq = seq;
+
+    status->progress = copy.progress;
+    status->eta = copy.eta;
+    status->error_code = copy.error_code;
+    status->bytes_done = copy.bytes_done;
+    status->bytes_total = copy.bytes_total;
+    status->seq = (int32_t)(seq >> 1);
+    memcpy(status->status, copy.status, sizeof(status->status));
+    memcpy(status->step, copy.step, sizeof(status->step));
+    memcpy(status->component, copy.component, sizeof(status->component));
+    memcpy(status->id, copy.id, sizeof(status->id));
+    status->status[sizeof(status->status) - 1] = '\0';
+    status->step[sizeof(status->step) - 1] = '\0';
+    status->component[sizeof(status->component) - 1] = '\0';
+    status->id[sizeof(status->id) - 1] = '\0';
+
+    return STATUS_BINARY_UPDATED;
+}
+
+void status_binary_close(void)
+{
+    if (record != NULL) {
+        munmap(record, sizeof(status_record_t));
+    }
+    record = NULL;
+}
+
+/**
+ * Write the record in place. The file must never be replaced or truncated
+ * while the tracker has it mapped.
+ */
+bool status_binary_publish(const char *path, const update_status_t *status)
+{
+    status_record_t *r;
+    struct stat st;
+    uint32_t seq;
+    void *map;
+    int fd;
+
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 ||
+        (st.st_size < (off_t)sizeof(status_record_t) && ftruncate(fd, sizeof(status_record_t)) != 0)) {
+        close(fd);
+        return false;
+    }
+    map = mmap(NULL, sizeof(status_record_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    r = map;
+
+    // An odd sequence number is left by a producer that died mid-write
+    seq = atomic_load_explicit(record_seq(r), memory_order_relaxed) | 1;
+    atomic_store_explicit(record_seq(r), seq, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    r->magic = STATUS_BINARY_MAGIC;
+    r->version = STATUS_BINARY_VERSION;
+    r->size = sizeof(status_record_t);
+    r->progress = status->progress;
+    r->eta = status->eta;
+    r->error_code = status->error_code;
+    r->bytes_done = status->bytes_done;
+    r->bytes_total = status->bytes_total;
+    strncpy(r->status, status->status, sizeof(r->status));
+    strncpy(r->step, status->step, sizeof(r->step));
+    strncpy(r->component, status->component, sizeof(r->component));
+    strncpy(r->id, status->id, sizeof(r->id));
+    r->crc = status_binary_crc32((const uint8_t *)r + CRC_START, CRC_LEN);
+
+    atomic_store_explicit(record_seq(r), seq + 1, memory_order_release);
+    munmap(map, sizeof(status_record_t));
+    return true;
+}
+
+#else /* UPDATE_TRACKER_USE_BINARY */
+
+/* No shared mappings on this platform: the JSON file is the only record */
+
+bool status_binary_open(const char *path)
+{
+    (void)path;
+    return false;
+}
+
+status_binary_result_t status_binary_read(update_status_t *status)
+{
+    (void)status;
+    return STATUS_BINARY_INVALID;
+}
+
+void status_binary_close(void)
+{
+}
+
+bool status_binary_publish(const char *path, const update_status_t *status)
+{
+    (void)path;
+    (void)status;
+    return false;
+}
+
+#endif /* UPDATE_TRACKER_USE_BINARY */
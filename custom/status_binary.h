@@ -0,0 +1,95 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * Binary status record, an alternative to the JSON status file.
+ * The record has a fixed little-endian layout. Producers update it in place
+ * under a sequence lock: seq is odd while a write is in progress and goes up
+ * by two with every complete status. The tracker maps the file once and
+ * copies the record out, so a change costs no system call and no parsing.
+ * tools/status_bin.py converts JSON documents into the record.
+ */
+
+#ifndef STATUS_BINARY_H_
+#define STATUS_BINARY_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define STATUS_BINARY_MAGIC     0x52535455u     // "UTSR"
+#define STATUS_BINARY_VERSION   1
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t magic;                             // STATUS_BINARY_MAGIC
+    uint16_t version;                           // STATUS_BINARY_VERSION
+    uint16_t size;                              // sizeof(status_record_t)
+    uint32_t seq;                               // sequence lock, odd while writing
+    int32_t progress;
+    int32_t eta;
+    int32_t error_code;
+    int64_t bytes_done;
+    int64_t bytes_total;
+    char status[UPDATE_STATUS_TEXT_LEN];
+    char step[UPDATE_STATUS_TEXT_LEN];
+    char component[UPDATE_STATUS_TEXT_LEN];
+    char id[UPDATE_STATUS_ID_LEN];
+    uint32_t crc;                               // CRC-32 of progress..id
+    uint32_t reserved;
+} status_record_t;
+
+typedef enum {
+    STATUS_BINARY_UNCHANGED,    // same sequence number as the last read
+    STATUS_BINARY_UPDATED,      // a new status was read
+    STATUS_BINARY_TORN,         // caught mid-write, try again
+    STATUS_BINARY_INVALID,      // missing, wrong magic, version or checksum
+} status_binary_result_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Map the record. Can be called again while the file does not exist yet.
+ * @return true if the record is mapped
+ */
+bool status_binary_open(const char *path);
+
+/**
+ * Read the record if its sequence number changed
+ * @param status receives the status on STATUS_BINARY_UPDATED, untouched otherwise
+ */
+status_binary_result_t status_binary_read(update_status_t *status);
+
+void status_binary_close(void);
+
+/**
+ * Producer side: write a status into the record, creating the file if needed
+ * @return true on success
+ */
+bool status_binary_publish(const char *path, const update_status_t *status);
+
+/**
+ * CRC-32 (IEEE 802.3, as zlib) of a buffer
+ */
+uint32_t status_binary_crc32(const void *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_BINARY_H_ */
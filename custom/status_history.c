@@ -0,0 +1,145 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "tracker_conf.h"
+#include "status_history.h"
+#include "status_publish.h"
+#include "tracker_stats.h"
+
+#if UPDATE_TRACKER_USE_HISTORY
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HISTORY_MASK        (UPDATE_TRACKER_HISTORY_LEN - 1)
+#define HISTORY_LINE_MAX    (3 * UPDATE_STATUS_TEXT_LEN + UPDATE_STATUS_ID_LEN + 96)
+
+_Static_assert((UPDATE_TRACKER_HISTORY_LEN & HISTORY_MASK) == 0, "history length must be a power of two");
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static status_history_entry_t ring[UPDATE_TRACKER_HISTORY_LEN];
+static atomic_uint started;     // entries the writer began, one ahead of committed while writing
+static atomic_uint committed;   // entries completely written
+
+/**
+ * Append a status, overwriting the oldest one when the ring is full
+ */
+void status_history_record(const update_status_t *status)
+{
+    unsigned int index = atomic_load_explicit(&committed, memory_order_relaxed);
+    status_history_entry_t *entry = &ring[index & HISTORY_MASK];
+
+    // Readers that see any of the new data also see the slot as taken
+    atomic_store_explicit(&started, index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    entry->time_us = tracker_stats_now_us();
+    entry->status = *status;
+
+    atomic_store_explicit(&committed, index + 1, memory_order_release);
+}
+
+uint32_t status_history_total(void)
+{
+    return atomic_load_explicit(&committed, memory_order_acquire);
+}
+
+/**
+ * Copy one entry, seqlock style: the copy is only valid if the writer did
+ * not start to reuse its slot meanwhile
+ */
+bool status_history_get(uint32_t age, status_history_entry_t *entry)
+{
+    unsigned int total = atomic_load_explicit(&committed, memory_order_acquire);
+    unsigned int index;
+
+    if (age >= total || age >= UPDATE_TRACKER_HISTORY_LEN) {
+        return false;
+    }
+    index = total - 1 - age;
+    *entry = ring[index & HISTORY_MASK];
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&started, memory_order_relaxed) - index <= UPDATE_TRACKER_HISTORY_LEN;
+}
+
+/**
+ * Write the ring oldest first
+ */
+bool status_history_dump(const char *path)
+{
+    size_t size = (size_t)UPDATE_TRACKER_HISTORY_LEN * HISTORY_LINE_MAX;
+    char *buf = malloc(size);
+    status_history_entry_t entry;
+    size_t pos = 0;
+    bool ok;
+
+    if (buf == NULL) {
+        return false;
+    }
+
+    for (uint32_t age = UPDATE_TRACKER_HISTORY_LEN; age-- > 0;) {
+        const update_status_t *s = &entry.status;
+        int n;
+
+        if (!status_history_get(age, &entry)) {
+            continue;
+        }
+        n = snprintf(buf + pos, size - pos, "%llu.%03u %3d%% error %ld seq %ld [%s] %s | %s | %s\n",
+                     (unsigned long long)(entry.time_us / 1000000), (unsigned)(entry.time_us / 1000 % 1000),
+                     s->progress, (long)s->error_code, (long)s->seq, s->id, s->status, s->step, s->component);
+        if (n > 0 && (size_t)n < size - pos) {
+            pos += (size_t)n;
+        }
+    }
+
+    ok = status_publish_write(path, buf, pos);
+    free(buf);
+    return ok;
+}
+
+#else /* UPDATE_TRACKER_USE_HISTORY */
+
+/* Without the ring only the count of statuses is kept */
+static uint32_t recorded = 0;
+
+void status_history_record(const update_status_t *status)
+{
+    (void)status;
+    recorded++;
+}
+
+uint32_t status_history_total(void)
+{
+    return recorded;
+}
+
+bool status_history_get(uint32_t age, status_history_entry_t *entry)
+{
+    (void)age;
+    (void)entry;
+    return false;
+}
+
+bool status_history_dump(const char *path)
+{
+    (void)path;
+    return false;
+}
+
+#endif /* UPDATE_TRACKER_USE_HISTORY */
@@ -0,0 +1,68 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * status_history - every status the tracker received, with its arrival time,
+ * in a fixed-size ring. The newest entries overwrite the oldest ones, so the
+ * timeline of an install costs no allocation. The ring has a single writer
+ * thread; readers in any thread detect entries overwritten while they copied
+ * them and skip those.
+ */
+
+#ifndef STATUS_HISTORY_H_
+#define STATUS_HISTORY_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint64_t time_us;           // monotonic arrival time, see tracker_stats_now_us()
+    update_status_t status;     // complete status after the update was applied
+} status_history_entry_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Append a status. Only one thread may record.
+ */
+void status_history_record(const update_status_t *status);
+
+/**
+ * Number of statuses recorded so far, including the overwritten ones
+ */
+uint32_t status_history_total(void);
+
+/**
+ * Copy a recorded status
+ * @param age 0 for the newest status, 1 for the one before...
+ * @param entry receives the status
+ * @return false if the status is not (or no longer) in the ring
+ */
+bool status_history_get(uint32_t age, status_history_entry_t *entry);
+
+/**
+ * Write the statuses still in the ring to a file, oldest first, one per line
+ * @return true if the file was written
+ */
+bool status_history_dump(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_HISTORY_H_ */
@@ -0,0 +1,226 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "tracker_conf.h"
+#include "tracker_log.h"
+#include "status_ingest.h"
+#include "status_json.h"
+#include "status_history.h"
+
+#if UPDATE_TRACKER_USE_SOCKET
+    #include <errno.h>
+    #include <unistd.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+#endif
+
+#if UPDATE_TRACKER_USE_SOCKET
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int ingest_fd = -1;
+static struct sockaddr_un ingest_addr;
+static uint32_t ingest_dropped = 0;
+
+/**
+ * Fill a socket address
+ * @return false if the path does not fit
+ */
+static bool make_address(const char *path, struct sockaddr_un *addr)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        return false;
+    }
+    strcpy(addr->sun_path, path);
+    return true;
+}
+
+/**
+ * Create the directory holding the socket if it is missing (one level only)
+ */
+static void make_parent_dir(const char *path)
+{
+    char dir[sizeof(ingest_addr.sun_path)];
+    const char *slash = strrchr(path, '/');
+
+    if (slash == NULL || slash == path) {
+        return;
+    }
+    memcpy(dir, path, (size_t)(slash - path));
+    dir[slash - path] = '\0';
+    mkdir(dir, 0755);
+}
+
+/**
+ * Bind the ingest socket
+ */
+bool status_ingest_init(const char *path)
+{
+    status_ingest_deinit();
+
+    if (!make_address(path, &ingest_addr)) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Socket path too long: %s\n", path);
+        return false;
+    }
+
+    ingest_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (ingest_fd < 0) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Cannot create ingest socket (%s)\n", strerror(errno));
+        return false;
+    }
+
+    make_parent_dir(path);
+    unlink(path);  // stale socket of a previous run
+    if (bind(ingest_fd, (const struct sockaddr *)&ingest_addr, sizeof(ingest_addr)) != 0) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Cannot bind %s (%s)\n", path, strerror(errno));
+        close(ingest_fd);
+        ingest_fd = -1;
+        return false;
+    }
+    if (chmod(path, UPDATE_TRACKER_SOCKET_MODE) != 0) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Cannot set the mode of %s (%s)\n", path, strerror(errno));
+    }
+
+    return true;
+}
+
+int status_ingest_get_fd(void)
+{
+    return ingest_fd;
+}
+
+/**
+ * Receive the queued documents, up to UPDATE_TRACKER_SOCKET_BURST, the newest one wins.
+ * The socket stays readable while more are queued, so the main loop comes back
+ * for them after a frame instead of a flooding producer starving the display.
+ */
+bool status_ingest_receive(update_status_t *status)
+{
+    char doc[STATUS_INGEST_MAX_DOC];
+    update_status_t next;
+    bool applied = false;
+
+    if (ingest_fd < 0) {
+        return false;
+    }
+
+    for (uint32_t handled = 0; handled < UPDATE_TRACKER_SOCKET_BURST; handled++) {
+        ssize_t len = recv(ingest_fd, doc, sizeof(doc), MSG_TRUNC);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;  // EAGAIN: queue drained
+        }
+        if ((size_t)len > sizeof(doc)) {
+            TRACKER_LOG_EVERY(TRACKER_LOG_WARN, 10000, "Update tracker: Dropped oversized status datagram (%zd bytes)\n", len);
+            ingest_dropped++;
+            continue;
+        }
+        // Decode on a copy, a datagram that fails half way leaves status as it was
+        next = *status;
+        if (status_json_decode(doc, (size_t)len, &next, NULL)) {
+            *status = next;
+            status_history_record(status);
+            applied = true;
+        } else {
+            TRACKER_LOG_EVERY(TRACKER_LOG_WARN, 10000, "Update tracker: Dropped malformed status datagram\n");
+            ingest_dropped++;
+        }
+    }
+
+    return applied;
+}
+
+uint32_t status_ingest_get_dropped(void)
+{
+    return ingest_dropped;
+}
+
+void status_ingest_deinit(void)
+{
+    if (ingest_fd >= 0) {
+        close(ingest_fd);
+        unlink(ingest_addr.sun_path);
+    }
+    ingest_fd = -1;
+}
+
+/**
+ * Producer side: send one document
+ */
+bool status_ingest_send(const char *path, const char *json, size_t len)
+{
+    struct sockaddr_un addr;
+    ssize_t sent;
+    int fd;
+
+    if (len > STATUS_INGEST_MAX_DOC || !make_address(path, &addr)) {
+        return false;
+    }
+
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    sent = sendto(fd, json, len, MSG_DONTWAIT, (const struct sockaddr *)&addr, sizeof(addr));
+    close(fd);
+
+    return sent == (ssize_t)len;
+}
+
+#else /* UPDATE_TRACKER_USE_SOCKET */
+
+/* No socket support on this platform: the status file is the only input */
+
+bool status_ingest_init(const char *path)
+{
+    (void)path;
+    return false;
+}
+
+int status_ingest_get_fd(void)
+{
+    return -1;
+}
+
+bool status_ingest_receive(update_status_t *status)
+{
+    (void)status;
+    return false;
+}
+
+uint32_t status_ingest_get_dropped(void)
+{
+    return 0;
+}
+
+void status_ingest_deinit(void)
+{
+}
+
+bool status_ingest_send(const char *path, const char *json, size_t len)
+{
+    (void)path;
+    (void)json;
+    (void)len;
+    return false;
+}
+
+#endif /* UPDATE_TRACKER_USE_SOCKET */
@@ -0,0 +1,75 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+/*
+ * Status ingest over a Unix datagram socket.
+ * Every datagram carries one complete status document in the same JSON
+ * format as the status file, e.g.
+ *  printf '{"progress": 40, "step": "Installing"}' | socat - UNIX-SENDTO:/run/update_tracker/status.sock
+ */
+
+#ifndef STATUS_INGEST_H_
+#define STATUS_INGEST_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/* Largest document accepted in one datagram */
+#define STATUS_INGEST_MAX_DOC 1024
+
+/**
+ * Bind the ingest socket. A stale socket file at path is replaced.
+ * @param path socket path
+ * @return true if the socket is listening
+ */
+bool status_ingest_init(const char *path);
+
+/**
+ * Get the descriptor that becomes readable when documents are queued.
+ * @return file descriptor or -1 if the socket is not bound
+ */
+int status_ingest_get_fd(void);
+
+/**
+ * Receive all queued documents without blocking.
+ * Documents are decoded in arrival order on top of status so the result is
+ * the newest state; malformed or truncated datagrams are dropped.
+ * @param status current status, updated in place
+ * @return true if at least one document was applied
+ */
+bool status_ingest_receive(update_status_t *status);
+
+/**
+ * Number of datagrams dropped as oversized or malformed since start
+ */
+uint32_t status_ingest_get_dropped(void);
+
+/**
+ * Close the socket and remove its file.
+ */
+void status_ingest_deinit(void);
+
+/**
+ * Producer side: send one status document to a tracker.
+ * @param path socket path the tracker listens on
+ * @param json document
+ * @param len length of json in bytes
+ * @return true if the datagram was queued
+ */
+bool status_ingest_send(const char *path, const char *json, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_INGEST_H_ */
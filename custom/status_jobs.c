@@ -0,0 +1,387 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "tracker_conf.h"
+#include "status_jobs.h"
+#include "status_json.h"
+
+#if IS_ZEPHYR
+    #include <zephyr/fs/fs.h>
+#else
+    #include <dirent.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define JOB_DOC_SIZE        1024            // one status document of a job directory
+#define JOBS_DOC_MAX_SIZE   (64 * 1024)     // largest multi-job document read
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static status_job_t *jobs;
+static bool *job_seen;              // per job: found in the document being loaded
+static uint32_t job_cnt = 0;
+static uint32_t job_capacity = 0;
+static uint32_t jobs_version = 0;
+static update_status_t *staged;     // jobs of a multi-job document, applied once it is well formed
+static uint32_t staged_cnt = 0;
+static uint32_t staged_capacity = 0;
+static bool staging_failed = false;
+
+/**
+ * Find a job by id with a binary search
+ * @param pos receives the index of the job, or where to insert it
+ * @return true if the job exists
+ */
+static bool find_job(const char *id, uint32_t *pos)
+{
+    uint32_t lo = 0;
+    uint32_t hi = job_cnt;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(jobs[mid].status.id, id);
+        if (cmp == 0) {
+            *pos = mid;
+            return true;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *pos = lo;
+    return false;
+}
+
+/**
+ * Add or update a job from a decoded status
+ */
+static void upsert_job(const update_status_t *status)
+{
+    uint32_t pos;
+
+    if (find_job(status->id, &pos)) {
+        job_seen[pos] = true;
+        if (memcmp(&jobs[pos].status, status, sizeof(*status)) != 0) {
+            jobs[pos].status = *status;
+            jobs[pos].version++;
+            jobs_version++;
+        }
+        return;
+    }
+
+    if (job_cnt >= UPDATE_TRACKER_MAX_JOBS) {
+        return;
+    }
+    if (job_cnt == job_capacity) {
+        uint32_t capacity = job_capacity ? job_capacity * 2 : 16;
+        status_job_t *new_jobs = lv_realloc(jobs, capacity * sizeof(status_job_t));
+        bool *new_seen;
+
+        if (new_jobs == NULL) {
+            return;
+        }
+        jobs = new_jobs;
+        new_seen = lv_realloc(job_seen, capacity * sizeof(bool));
+        if (new_seen == NULL) {
+            return;
+        }
+        job_seen = new_seen;
+        job_capacity = capacity;
+    }
+
+    memmove(&jobs[pos + 1], &jobs[pos], (job_cnt - pos) * sizeof(status_job_t));
+    memmove(&job_seen[pos + 1], &job_seen[pos], (job_cnt - pos) * sizeof(bool));
+    jobs[pos].status = *status;
+    jobs[pos].version = 0;
+    job_seen[pos] = true;
+    job_cnt++;
+    jobs_version++;
+}
+
+/**
+ * Decode one job document
+ * @param default_id id used when the document has none, may be NULL
+ */
+static bool decode_job(const char *json, size_t len, const char *default_id, update_status_t *status)
+{
+    uint32_t fields = 0;
+
+    memset(status, 0, sizeof(*status));
+    status->eta = -1;
+    if (!status_json_decode(json, len, status, &fields)) {
+        return false;
+    }
+    if (!(fields & UPDATE_FIELD_ID)) {
+        if (default_id == NULL) {
+            return false;
+        }
+        strncpy(status->id, default_id, sizeof(status->id) - 1);
+    }
+    return status->id[0] != '\0';
+}
+
+/**
+ * Stage one element of a multi-job document, the jobs are left alone until
+ * the whole document decoded
+ */
+static void job_element_cb(const char *json, size_t len, void *user_data)
+{
+    update_status_t status;
+
+    LV_UNUSED(user_data);
+    if (!decode_job(json, len, NULL, &status) || staged_cnt >= UPDATE_TRACKER_MAX_JOBS) {
+        return;
+    }
+    if (staged_cnt == staged_capacity) {
+        uint32_t capacity = staged_capacity ? staged_capacity * 2 : 16;
+        update_status_t *new_staged = lv_realloc(staged, capacity * sizeof(update_status_t));
+
+        if (new_staged == NULL) {
+            staging_failed = true;
+            return;
+        }
+        staged = new_staged;
+        staged_capacity = capacity;
+    }
+    staged[staged_cnt++] = status;
+}
+
+static void mark_unseen(void)
+{
+    for (uint32_t i = 0; i < job_cnt; i++) {
+        job_seen[i] = false;
+    }
+}
+
+/**
+ * Remove the jobs the last load did not see
+ */
+static void remove_unseen(void)
+{
+    uint32_t kept = 0;
+
+    for (uint32_t i = 0; i < job_cnt; i++) {
+        if (job_seen[i]) {
+            jobs[kept] = jobs[i];
+            job_seen[kept] = true;
+            kept++;
+        }
+    }
+    if (kept != job_cnt) {
+        job_cnt = kept;
+        jobs_version++;
+    }
+}
+
+bool status_jobs_apply_document(const char *json, size_t len)
+{
+    staged_cnt = 0;
+    staging_failed = false;
+    // A job dropped for lack of memory would be removed, keep the jobs as they are instead
+    if (!status_json_decode_jobs(json, len, job_element_cb, NULL) || staging_failed) {
+        return false;
+    }
+    mark_unseen();
+    for (uint32_t i = 0; i < staged_cnt; i++) {
+        upsert_job(&staged[i]);
+    }
+    remove_unseen();
+    return true;
+}
+
+/**
+ * Read a whole file into an lv_malloc'ed, NUL terminated buffer
+ */
+static char *read_file(const char *path, size_t max_size, size_t *len)
+{
+    char *buf;
+#if IS_ZEPHYR
+    struct fs_dirent entry;
+    struct fs_file_t file;
+    ssize_t ret;
+
+    if (fs_stat(path, &entry) != 0 || entry.size == 0 || entry.size > max_size) {
+        return NULL;
+    }
+    buf = lv_malloc(entry.size + 1);
+    if (buf == NULL) {
+        return NULL;
+    }
+    fs_file_t_init(&file);
+    if (fs_open(&file, path, FS_O_READ) != 0) {
+        lv_free(buf);
+        return NULL;
+    }
+    ret = fs_read(&file, buf, entry.size);
+    fs_close(&file);
+    if (ret <= 0) {
+        lv_free(buf);
+        return NULL;
+    }
+    *len = (size_t)ret;
+#else
+    FILE *f = fopen(path, "rb");
+    long size;
+
+    if (f == NULL) {
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) <= 0 || (size_t)size > max_size ||
+        fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return NULL;
+    }
+    buf = lv_malloc((size_t)size + 1);
+    if (buf == NULL) {
+        fclose(f);
+        return NULL;
+    }
+    *len = fread(buf, 1, (size_t)size, f);
+    fclose(f);
+#endif
+    buf[*len] = '\0';
+    return buf;
+}
+
+bool status_jobs_load_file(const char *path)
+{
+    size_t len = 0;
+    char *doc = read_file(path, JOBS_DOC_MAX_SIZE, &len);
+    bool ok;
+
+    if (doc == NULL) {
+        return false;
+    }
+    ok = status_jobs_apply_document(doc, len);
+    lv_free(doc);
+    return ok;
+}
+
+/**
+ * Load one file of a job directory, keyed by its name when the document has no id
+ * @return false if a job document could not be read or decoded
+ */
+static bool load_dir_entry(const char *dir, const char *name)
+{
+    char path[256];
+    char id[UPDATE_STATUS_ID_LEN];
+    const char *ext = strrchr(name, '.');
+    size_t id_len;
+    size_t len = 0;
+    char *doc;
+    update_status_t status;
+    bool ok;
+
+    // Only published documents, not the temporary files of a write in progress
+    if (ext == NULL || strcmp(ext, ".json") != 0 || name[0] == '.') {
+        return true;
+    }
+    id_len = (size_t)(ext - name);
+    if (id_len >= sizeof(id) || snprintf(path, sizeof(path), "%s/%s", dir, name) >= (int)sizeof(path)) {
+        return true;
+    }
+    memcpy(id, name, id_len);
+    id[id_len] = '\0';
+
+    doc = read_file(path, JOB_DOC_SIZE, &len);
+    if (doc == NULL) {
+        return false;
+    }
+    ok = decode_job(doc, len, id, &status);
+    if (ok) {
+        upsert_job(&status);
+    }
+    lv_free(doc);
+    return ok;
+}
+
+bool status_jobs_load_dir(const char *path)
+{
+    bool complete = true;
+#if IS_ZEPHYR
+    struct fs_dir_t dir;
+    struct fs_dirent entry;
+
+    fs_dir_t_init(&dir);
+    if (fs_opendir(&dir, path) != 0) {
+        return false;
+    }
+    mark_unseen();
+    while (fs_readdir(&dir, &entry) == 0 && entry.name[0] != '\0') {
+        if (entry.type == FS_DIR_ENTRY_FILE && !load_dir_entry(path, entry.name)) {
+            complete = false;
+        }
+    }
+    fs_closedir(&dir);
+#else
+    DIR *dir = opendir(path);
+    struct dirent *entry;
+
+    if (dir == NULL) {
+        return false;
+    }
+    mark_unseen();
+    while ((entry = readdir(dir)) != NULL) {
+        if (!load_dir_entry(path, entry->d_name)) {
+            complete = false;
+        }
+    }
+    closedir(dir);
+#endif
+    // A document caught mid-write can't tell which job it holds, keep the jobs not seen this time
+    if (complete) {
+        remove_unseen();
+    }
+    return true;
+}
+
+void status_jobs_clear(void)
+{
+    // Called on every check while the jobs are gone, only an actual change bumps the version
+    if (job_cnt > 0) {
+        jobs_version++;
+    }
+    lv_free(jobs);
+    lv_free(job_seen);
+    lv_free(staged);
+    jobs = NULL;
+    job_seen = NULL;
+    staged = NULL;
+    job_cnt = 0;
+    job_capacity = 0;
+    staged_cnt = 0;
+    staged_capacity = 0;
+}
+
+uint32_t status_jobs_get_count(void)
+{
+    return job_cnt;
+}
+
+const status_job_t *status_jobs_get(uint32_t index)
+{
+    return index < job_cnt ? &jobs[index] : NULL;
+}
+
+uint32_t status_jobs_get_version(void)
+{
+    return jobs_version;
+}
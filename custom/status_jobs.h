@@ -0,0 +1,78 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * status_jobs - status of several concurrent updates, such as the downstream
+ * controllers of a gateway. Jobs are keyed by their "id" and kept sorted by
+ * it, so a list shows them in a stable order.
+ */
+
+#ifndef STATUS_JOBS_H_
+#define STATUS_JOBS_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    update_status_t status;
+    uint32_t version;       // bumped each time the job changes
+} status_job_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Replace the jobs with the ones of a multi-job document, see status_json_decode_jobs()
+ * Jobs missing from the document are removed, unless the document is malformed.
+ * @return false if the document is malformed
+ */
+bool status_jobs_apply_document(const char *json, size_t len);
+
+/**
+ * Load the jobs from a directory holding one status document per job.
+ * A document without "id" is keyed by its file name without extension.
+ * Jobs without a document are removed, unless one of the documents can't be
+ * read or decoded: the jobs are kept then, the unreadable one may be any of them.
+ * @return false if the directory can't be read
+ */
+bool status_jobs_load_dir(const char *path);
+
+/**
+ * Load the jobs from a multi-job document
+ * @return false if the file can't be read or is malformed
+ */
+bool status_jobs_load_file(const char *path);
+
+void status_jobs_clear(void);
+uint32_t status_jobs_get_count(void);
+
+/**
+ * Get a job by its position in id order
+ * @return NULL past the last job
+ */
+const status_job_t *status_jobs_get(uint32_t index);
+
+/**
+ * Get a counter bumped each time a job is added, removed or changed
+ */
+uint32_t status_jobs_get_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_JOBS_H_ */
@@ -0,0 +1,598 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include <stdlib.h>
+#include "status_json.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MAX_KEY_LEN     32  // longer keys can't be in the table and are skipped
+#define MAX_NUMBER_LEN  32
+#define MAX_SKIP_DEPTH  16  // nesting allowed inside skipped values
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    FIELD_INT,
+    FIELD_INT64,
+    FIELD_TEXT,
+} field_type_t;
+
+/* Where a key of the document is stored in update_status_t */
+typedef struct {
+    const char *key;
+    uint8_t key_len;
+    uint8_t type;
+    uint16_t offset;
+    uint16_t size;
+    uint32_t flag;
+} status_field_t;
+
+/* Read position inside the document */
+typedef struct {
+    const char *p;
+    const char *end;
+} json_cursor_t;
+
+#define STATUS_FIELD(name, field_type, member, field_flag) \
+    { name, sizeof(name) - 1, field_type, offsetof(update_status_t, member), \
+      sizeof(((update_status_t *)0)->member), field_flag }
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const status_field_t status_fields[] = {
+    STATUS_FIELD("progress",    FIELD_INT,   progress,    UPDATE_FIELD_PROGRESS),
+    STATUS_FIELD("status",      FIELD_TEXT,  status,      UPDATE_FIELD_STATUS),
+    STATUS_FIELD("step",        FIELD_TEXT,  step,        UPDATE_FIELD_STEP),
+    STATUS_FIELD("eta",         FIELD_INT,   eta,         UPDATE_FIELD_ETA),
+    STATUS_FIELD("bytes_done",  FIELD_INT64, bytes_done,  UPDATE_FIELD_BYTES_DONE),
+    STATUS_FIELD("bytes_total", FIELD_INT64, bytes_total, UPDATE_FIELD_BYTES_TOTAL),
+    STATUS_FIELD("component",   FIELD_TEXT,  component,   UPDATE_FIELD_COMPONENT),
+    STATUS_FIELD("error_code",  FIELD_INT,   error_code,  UPDATE_FIELD_ERROR_CODE),
+    STATUS_FIELD("seq",         FIELD_INT,   seq,         UPDATE_FIELD_SEQ),
+    STATUS_FIELD("id",          FIELD_TEXT,  id,          UPDATE_FIELD_ID),
+};
+
+#define STATUS_FIELD_COUNT (sizeof(status_fields) / sizeof(status_fields[0]))
+
+_Static_assert(STATUS_FIELD_COUNT <= 32, "field bits must fit in a uint32_t");
+
+/**
+ * Skip JSON whitespace
+ * @return true if there is more input
+ */
+static bool skip_ws(json_cursor_t *c)
+{
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+        c->p++;
+    }
+    return c->p < c->end;
+}
+
+/**
+ * Consume an expected character after optional whitespace
+ */
+static bool expect_char(json_cursor_t *c, char ch)
+{
+    if (!skip_ws(c) || *c->p != ch) {
+        return false;
+    }
+    c->p++;
+    return true;
+}
+
+/**
+ * Append a code point as UTF-8
+ * @return number of bytes written, 0 if it does not fit
+ */
+static size_t put_utf8(char *out, size_t room, uint32_t cp)
+{
+    if (cp < 0x80) {
+        if (room < 1) return 0;
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        if (room < 2) return 0;
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        if (room < 3) return 0;
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    if (room < 4) return 0;
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/**
+ * Read the four hex digits of a \u escape
+ */
+static bool read_hex4(json_cursor_t *c, uint32_t *value)
+{
+    uint32_t v = 0;
+
+    if (c->end - c->p < 4) {
+        return false;
+    }
+    for (int i = 0; i < 4; i++) {
+        char ch = *c->p++;
+        v <<= 4;
+        if (ch >= '0' && ch <= '9') v |= (uint32_t)(ch - '0');
+        else if (ch >= 'a' && ch <= 'f') v |= (uint32_t)(ch - 'a' + 10);
+        else if (ch >= 'A' && ch <= 'F') v |= (uint32_t)(ch - 'A' + 10);
+        else return false;
+    }
+    *value = v;
+    return true;
+}
+
+/**
+ * Parse a string starting at the opening quote and decode its escapes.
+ * The result is truncated to fit out (on a UTF-8 character boundary) but the
+ * whole string is always consumed. out may be NULL to only skip the string.
+ * @param truncated optional, set to true if the string did not fit
+ */
+static bool parse_string(json_cursor_t *c, char *out, size_t out_size, bool *truncated)
+{
+    size_t len = 0;
+    bool full = (out == NULL);
+
+    if (c->p >= c->end || *c->p != '"') {
+        return false;
+    }
+    c->p++;
+
+    while (c->p < c->end) {
+        char ch = *c->p++;
+        uint32_t cp;
+
+        if (ch == '"') {
+            if (out != NULL) {
+                out[len] = '\0';
+            }
+            if (truncated != NULL) {
+                *truncated = full && out != NULL;
+            }
+            return true;
+        }
+        if ((unsigned char)ch < 0x20) {
+            return false;  // control characters must be escaped
+        }
+
+        if (ch != '\\') {
+            // Plain byte, drop the partial character once the buffer is full
+            if (!full && len + 1 < out_size) {
+                out[len++] = ch;
+            } else if (!full) {
+                full = true;
+                if (((unsigned char)ch & 0xC0) == 0x80) {
+                    // Cut inside a multi-byte character, drop what was copied of it
+                    while (len > 0 && ((unsigned char)out[len - 1] & 0xC0) == 0x80) {
+                        len--;
+                    }
+                    if (len > 0) {
+                        len--;
+                    }
+                }
+            }
+            continue;
+        }
+
+        if (c->p >= c->end) {
+            return false;
+        }
+        switch (*c->p++) {
+            case '"':  cp = '"';  break;
+            case '\\': cp = '\\'; break;
+            case '/':  cp = '/';  break;
+            case 'b':  cp = '\b'; break;
+            case 'f':  cp = '\f'; break;
+            case 'n':  cp = '\n'; break;
+            case 'r':  cp = '\r'; break;
+            case 't':  cp = '\t'; break;
+            case 'u':
+                if (!read_hex4(c, &cp)) {
+                    return false;
+                }
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // High surrogate, must be followed by a low one
+                    uint32_t low;
+                    if (c->end - c->p < 2 || c->p[0] != '\\' || c->p[1] != 'u') {
+                        return false;
+                    }
+                    c->p += 2;
+                    if (!read_hex4(c, &low) || low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+
+        if (!full) {
+            size_t n = put_utf8(out + len, out_size - 1 - len, cp);
+            if (n == 0) {
+                full = true;
+            }
+            len += n;
+        }
+    }
+
+    return false;  // document ended inside the string
+}
+
+/**
+ * Parse a number, keeping the integer part (fractions are truncated)
+ */
+static bool parse_number(json_cursor_t *c, int64_t *value)
+{
+    char token[MAX_NUMBER_LEN];
+    const char *start = c->p;
+    bool is_integer = true;
+    size_t len;
+
+    if (c->p < c->end && *c->p == '-') {
+        c->p++;
+    }
+    if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+        return false;
+    }
+    while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+        c->p++;
+    }
+    if (c->p < c->end && *c->p == '.') {
+        is_integer = false;
+        c->p++;
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+            return false;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            c->p++;
+        }
+    }
+    if (c->p < c->end && (*c->p == 'e' || *c->p == 'E')) {
+        is_integer = false;
+        c->p++;
+        if (c->p < c->end && (*c->p == '+' || *c->p == '-')) {
+            c->p++;
+        }
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+            return false;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            c->p++;
+        }
+    }
+    // A number running into the end of the buffer may have been cut short
+    if (c->p >= c->end) {
+        return false;
+    }
+
+    len = (size_t)(c->p - start);
+    if (len >= sizeof(token)) {
+        len = sizeof(token) - 1;
+    }
+    memcpy(token, start, len);
+    token[len] = '\0';
+
+    if (is_integer) {
+        *value = strtoll(token, NULL, 10);
+    } else {
+        double d = strtod(token, NULL);
+        if (d > (double)INT64_MAX) d = (double)INT64_MAX;
+        if (d < (double)INT64_MIN) d = (double)INT64_MIN;
+        *value = (int64_t)d;
+    }
+    return true;
+}
+
+/**
+ * Consume a literal such as true, false or null
+ */
+static bool parse_literal(json_cursor_t *c, const char *word)
+{
+    size_t len = strlen(word);
+    if ((size_t)(c->end - c->p) < len || memcmp(c->p, word, len) != 0) {
+        return false;
+    }
+    c->p += len;
+    return true;
+}
+
+/**
+ * Skip over any value, including nested objects and arrays
+ */
+static bool skip_value(json_cursor_t *c, int depth)
+{
+    int64_t ignored;
+
+    if (depth > MAX_SKIP_DEPTH || !skip_ws(c)) {
+        return false;
+    }
+
+    switch (*c->p) {
+        case '"':
+            return parse_string(c, NULL, 0, NULL);
+        case '{':
+        case '[': {
+            char close = (*c->p == '{') ? '}' : ']';
+            c->p++;
+            if (!skip_ws(c)) {
+                return false;
+            }
+            if (*c->p == close) {
+                c->p++;
+                return true;
+            }
+            for (;;) {
+                if (close == '}') {
+                    if (!skip_ws(c) || !parse_string(c, NULL, 0, NULL) || !expect_char(c, ':')) {
+                        return false;
+                    }
+                }
+                if (!skip_value(c, depth + 1) || !skip_ws(c)) {
+                    return false;
+                }
+                if (*c->p == ',') {
+                    c->p++;
+                } else if (*c->p == close) {
+                    c->p++;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+        }
+        case 't':
+            return parse_literal(c, "true");
+        case 'f':
+            return parse_literal(c, "false");
+        case 'n':
+            return parse_literal(c, "null");
+        default:
+            return parse_number(c, &ignored);
+    }
+}
+
+/**
+ * Look a key up in the field table
+ */
+static const status_field_t *find_field(const char *key, size_t key_len)
+{
+    for (size_t i = 0; i < STATUS_FIELD_COUNT; i++) {
+        const status_field_t *f = &status_fields[i];
+        if (f->key_len == key_len && memcmp(f->key, key, key_len) == 0) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Parse the value of a known key into its field.
+ * A value of the wrong type is skipped and the field keeps its value.
+ */
+static bool parse_field(json_cursor_t *c, const status_field_t *f, update_status_t *status, uint32_t *found)
+{
+    uint8_t *dst = (uint8_t *)status + f->offset;
+    int64_t number;
+
+    if (!skip_ws(c)) {
+        return false;
+    }
+
+    if (f->type == FIELD_TEXT) {
+        if (*c->p != '"') {
+            return skip_value(c, 0);
+        }
+        if (!parse_string(c, (char *)dst, f->size, NULL)) {
+            return false;
+        }
+    } else {
+        if (*c->p != '-' && (*c->p < '0' || *c->p > '9')) {
+            return skip_value(c, 0);
+        }
+        if (!parse_number(c, &number)) {
+            return false;
+        }
+        if (f->type == FIELD_INT) {
+            if (number > INT32_MAX) number = INT32_MAX;
+            if (number < INT32_MIN) number = INT32_MIN;
+            int32_t v = (int32_t)number;
+            memcpy(dst, &v, sizeof(v));
+        } else {
+            memcpy(dst, &number, sizeof(number));
+        }
+    }
+
+    *found |= f->flag;
+    return true;
+}
+
+/**
+ * Decode a status document in a single pass
+ */
+bool status_json_decode(const char *json, size_t len, update_status_t *status, uint32_t *fields)
+{
+    update_status_t decoded = *status;
+    uint32_t found = 0;
+    json_cursor_t c;
+    const char *nul = memchr(json, '\0', len);
+
+    c.p = json;
+    c.end = nul ? nul : json + len;
+
+    if (!expect_char(&c, '{') || !skip_ws(&c)) {
+        return false;
+    }
+
+    if (*c.p == '}') {
+        c.p++;
+    } else {
+        for (;;) {
+            char key[MAX_KEY_LEN + 1];
+            bool key_truncated = false;
+            const status_field_t *f;
+
+            if (!skip_ws(&c) || !parse_string(&c, key, sizeof(key), &key_truncated) || !expect_char(&c, ':')) {
+                return false;
+            }
+
+            f = key_truncated ? NULL : find_field(key, strlen(key));
+            if (f != NULL) {
+                if (!parse_field(&c, f, &decoded, &found)) {
+                    return false;
+                }
+            } else if (!skip_value(&c, 0)) {
+                return false;
+            }
+
+            if (!skip_ws(&c)) {
+                return false;
+            }
+            if (*c.p == ',') {
+                c.p++;
+            } else if (*c.p == '}') {
+                c.p++;
+                break;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    // Only whitespace may follow the document
+    if (skip_ws(&c)) {
+        return false;
+    }
+
+    *status = decoded;
+    if (fields != NULL) {
+        *fields = found;
+    }
+    return true;
+}
+
+/**
+ * Copy the fields selected by fields, text is kept NUL terminated
+ */
+void status_json_merge(update_status_t *status, const update_status_t *src, uint32_t fields)
+{
+    for (size_t i = 0; i < STATUS_FIELD_COUNT; i++) {
+        const status_field_t *f = &status_fields[i];
+        if (fields & f->flag) {
+            memcpy((uint8_t *)status + f->offset, (const uint8_t *)src + f->offset, f->size);
+            if (f->type == FIELD_TEXT) {
+                ((char *)status + f->offset)[f->size - 1] = '\0';
+            }
+        }
+    }
+}
+
+/**
+ * Walk the "jobs" array of a multi-job document
+ */
+bool status_json_decode_jobs(const char *json, size_t len, status_json_job_cb_t cb, void *user_data)
+{
+    json_cursor_t c;
+    const char *nul = memchr(json, '\0', len);
+    bool has_jobs = false;
+
+    c.p = json;
+    c.end = nul ? nul : json + len;
+
+    if (!expect_char(&c, '{') || !skip_ws(&c)) {
+        return false;
+    }
+
+    if (*c.p == '}') {
+        c.p++;
+    } else {
+        for (;;) {
+            char key[MAX_KEY_LEN + 1];
+            bool key_truncated = false;
+
+            if (!skip_ws(&c) || !parse_string(&c, key, sizeof(key), &key_truncated) || !expect_char(&c, ':')) {
+                return false;
+            }
+
+            if (!key_truncated && strcmp(key, "jobs") == 0 && skip_ws(&c) && *c.p == '[') {
+                has_jobs = true;
+                c.p++;
+                if (!skip_ws(&c)) {
+                    return false;
+                }
+                if (*c.p == ']') {
+                    c.p++;
+                } else {
+                    for (;;) {
+                        const char *start;
+                        if (!skip_ws(&c)) {
+                            return false;
+                        }
+                        start = c.p;
+                        if (!skip_value(&c, 0)) {
+                            return false;
+                        }
+                        // Each element is decoded on its own, like a single status document
+                        cb(start, (size_t)(c.p - start), user_data);
+                        if (!skip_ws(&c)) {
+                            return false;
+                        }
+                        if (*c.p == ',') {
+                            c.p++;
+                        } else if (*c.p == ']') {
+                            c.p++;
+                            break;
+                        } else {
+                            return false;
+                        }
+                    }
+                }
+            } else if (!skip_value(&c, 0)) {
+                return false;
+            }
+
+            if (!skip_ws(&c)) {
+                return false;
+            }
+            if (*c.p == ',') {
+                c.p++;
+            } else if (*c.p == '}') {
+                c.p++;
+                break;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    return has_jobs && !skip_ws(&c);
+}
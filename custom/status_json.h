@@ -0,0 +1,60 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+#ifndef STATUS_JSON_H_
+#define STATUS_JSON_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/**
+ * Decode a status document in a single pass.
+ * Only the top level object is inspected: known keys are stored into status,
+ * unknown keys (including nested objects and arrays) are skipped. Fields that
+ * are missing keep the value status already holds.
+ * @param json document, does not need to be NUL terminated
+ * @param len number of bytes in json; decoding also stops at a NUL byte
+ * @param status decoded fields are stored here; left untouched on failure
+ * @param fields optional, receives the UPDATE_FIELD_* bits of the keys found
+ * @return false if the document is malformed or truncated
+ */
+bool status_json_decode(const char *json, size_t len, update_status_t *status, uint32_t *fields);
+
+/**
+ * Apply a partial status received in binary form, the counterpart of the
+ * keys missing from a document
+ * @param status updated in place
+ * @param src new values
+ * @param fields UPDATE_FIELD_* bits of the members to take from src
+ */
+void status_json_merge(update_status_t *status, const update_status_t *src, uint32_t fields);
+
+/**
+ * Called with the text of one element of a "jobs" array
+ */
+typedef void (*status_json_job_cb_t)(const char *json, size_t len, void *user_data);
+
+/**
+ * Walk a multi-job document: {"jobs": [{"id": "...", "progress": ...}, ...]}
+ * The elements are handed to cb as they are found, to be decoded with
+ * status_json_decode(). Elements already handed over stay valid when the
+ * document turns out to be malformed later on.
+ * @return false if the document is malformed or has no "jobs" array
+ */
+bool status_json_decode_jobs(const char *json, size_t len, status_json_job_cb_t cb, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_JSON_H_ */
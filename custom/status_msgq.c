@@ -0,0 +1,96 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tracker_conf.h"
+#include "status_msgq.h"
+#include "status_json.h"
+#include "status_history.h"
+
+#if UPDATE_TRACKER_USE_MSGQ
+    #include <zephyr/kernel.h>
+    #include "lvgl.h"
+#endif
+
+#if UPDATE_TRACKER_USE_MSGQ
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+K_MSGQ_DEFINE(status_msgq, sizeof(status_msg_t), UPDATE_TRACKER_MSGQ_DEPTH, 4);
+K_SEM_DEFINE(status_msgq_wake, 0, 1);
+
+/**
+ * Queue one status and wake the LVGL thread
+ */
+bool status_msgq_post(const update_status_t *status, uint32_t fields, int32_t timeout_ms)
+{
+    status_msg_t msg;
+
+    msg.fields = fields;
+    msg.status = *status;
+    if (k_msgq_put(&status_msgq, &msg, timeout_ms > 0 ? K_MSEC(timeout_ms) : K_NO_WAIT) != 0) {
+        return false;
+    }
+    k_sem_give(&status_msgq_wake);
+    return true;
+}
+
+/**
+ * Drain the queue, later statuses override the fields of earlier ones
+ */
+bool status_msgq_receive(update_status_t *status)
+{
+    status_msg_t msg;
+    bool applied = false;
+
+    while (k_msgq_get(&status_msgq, &msg, K_NO_WAIT) == 0) {
+        status_json_merge(status, &msg.status, msg.fields);
+        status_history_record(status);
+        applied = true;
+    }
+
+    return applied;
+}
+
+bool status_msgq_wait(uint32_t timeout_ms)
+{
+    k_timeout_t timeout = timeout_ms == LV_NO_TIMER_READY ? K_FOREVER : K_MSEC(timeout_ms);
+
+    return k_sem_take(&status_msgq_wake, timeout) == 0;
+}
+
+#else /* UPDATE_TRACKER_USE_MSGQ */
+
+/* No message queue on this platform: files and the socket are the only inputs */
+
+bool status_msgq_post(const update_status_t *status, uint32_t fields, int32_t timeout_ms)
+{
+    (void)status;
+    (void)fields;
+    (void)timeout_ms;
+    return false;
+}
+
+bool status_msgq_receive(update_status_t *status)
+{
+    (void)status;
+    return false;
+}
+
+bool status_msgq_wait(uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    return false;
+}
+
+#endif /* UPDATE_TRACKER_USE_MSGQ */
@@ -0,0 +1,75 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * Status ingest over a Zephyr message queue.
+ * Producers in other threads post fixed-size binary statuses, the LVGL
+ * thread picks them up without a round trip through the filesystem, at the
+ * next poll of the update timer.
+ * This tree has no Zephyr port, only the queue and its producer side ship.
+ * A Zephyr application that wants a post to wake it right away can sleep
+ * in status_msgq_wait() instead of k_msleep() in its main loop:
+ *  while (1) {
+ *      status_msgq_wait(lv_timer_handler());
+ *      custom_process_events();
+ *  }
+ */
+
+#ifndef STATUS_MSGQ_H_
+#define STATUS_MSGQ_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* One queued status */
+typedef struct {
+    uint32_t fields;            // UPDATE_FIELD_* bits of the members that are set
+    update_status_t status;
+} status_msg_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Producer side: queue a status for the tracker.
+ * Safe to call from any thread, not from an ISR unless timeout_ms is 0.
+ * @param status new values
+ * @param fields UPDATE_FIELD_* bits of the members of status to apply
+ * @param timeout_ms how long to wait for room in a full queue, 0 to fail at once
+ * @return true if the status was queued
+ */
+bool status_msgq_post(const update_status_t *status, uint32_t fields, int32_t timeout_ms);
+
+/**
+ * Apply all queued statuses without blocking, in arrival order.
+ * @param status current status, updated in place
+ * @return true if at least one status was applied
+ */
+bool status_msgq_receive(update_status_t *status);
+
+/**
+ * Sleep until a status is posted or the timeout expires, for a main loop
+ * of the application; nothing in this tree calls it
+ * @param timeout_ms longest sleep, LV_NO_TIMER_READY to wait for a post only
+ * @return true if woken by a post
+ */
+bool status_msgq_wait(uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_MSGQ_H_ */
@@ -0,0 +1,265 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tracker_conf.h"
+#include "status_publish.h"
+
+#if IS_ZEPHYR
+    #include <zephyr/fs/fs.h>
+#elif defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TEMP_SUFFIX      ".XXXXXX"
+#define MAX_PATH_LEN     256
+
+/**
+ * Atomically replace a file with new content
+ */
+bool status_publish_write(const char *path, const char *data, size_t len)
+{
+    char temp[MAX_PATH_LEN];
+
+    if (snprintf(temp, sizeof(temp), "%s" TEMP_SUFFIX, path) >= (int)sizeof(temp)) {
+        return false;
+    }
+
+#if IS_ZEPHYR
+    struct fs_file_t file;
+    ssize_t written;
+
+    fs_file_t_init(&file);
+    fs_unlink(temp);
+    if (fs_open(&file, temp, FS_O_CREATE | FS_O_WRITE) != 0) {
+        return false;
+    }
+    written = fs_write(&file, data, len);
+    fs_close(&file);
+    if (written != (ssize_t)len) {
+        fs_unlink(temp);
+        return false;
+    }
+    if (fs_rename(temp, path) != 0) {
+        fs_unlink(temp);
+        return false;
+    }
+    return true;
+#elif defined(_WIN32) || defined(_WIN64)
+    FILE *f = fopen(temp, "wb");
+    size_t written;
+
+    if (!f) {
+        return false;
+    }
+    written = fwrite(data, 1, len, f);
+    if (fclose(f) != 0 || written != len) {
+        remove(temp);
+        return false;
+    }
+    // rename() does not replace an existing file here, so this step is not atomic
+    remove(path);
+    if (rename(temp, path) != 0) {
+        remove(temp);
+        return false;
+    }
+    return true;
+#else
+    int fd = mkstemp(temp);
+    size_t done = 0;
+
+    if (fd < 0) {
+        return false;
+    }
+    // mkstemp() creates the file private to the producer
+    fchmod(fd, 0644);
+
+    while (done < len) {
+        ssize_t n = write(fd, data + done, len - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            unlink(temp);
+            return false;
+        }
+        done += (size_t)n;
+    }
+    // No fsync: rename() already makes the swap atomic for readers, and the
+    // status does not need to survive a power cut
+    if (close(fd) != 0 || rename(temp, path) != 0) {
+        unlink(temp);
+        return false;
+    }
+    return true;
+#endif
+}
+
+/**
+ * Append a JSON string literal, escaping what JSON requires
+ * @return false if it does not fit
+ */
+static bool append_string(char *buf, size_t size, size_t *pos, const char *text)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t p = *pos;
+
+    if (p + 1 >= size) {
+        return false;
+    }
+    buf[p++] = '"';
+
+    for (const unsigned char *s = (const unsigned char *)text; *s; s++) {
+        char esc = 0;
+        switch (*s) {
+            case '"':  esc = '"';  break;
+            case '\\': esc = '\\'; break;
+            case '\n': esc = 'n';  break;
+            case '\r': esc = 'r';  break;
+            case '\t': esc = 't';  break;
+            default: break;
+        }
+        if (esc) {
+            if (p + 2 >= size) return false;
+            buf[p++] = '\\';
+            buf[p++] = esc;
+        } else if (*s < 0x20) {
+            if (p + 6 >= size) return false;
+            buf[p++] = '\\';
+            buf[p++] = 'u';
+            buf[p++] = '0';
+            buf[p++] = '0';
+            buf[p++] = hex[*s >> 4];
+            buf[p++] = hex[*s & 0xF];
+        } else {
+            if (p + 1 >= size) return false;
+            buf[p++] = (char)*s;
+        }
+    }
+
+    if (p + 1 >= size) {
+        return false;
+    }
+    buf[p++] = '"';
+    buf[p] = '\0';
+    *pos = p;
+    return true;
+}
+
+/**
+ * Append formatted text
+ * @return false if it does not fit
+ */
+static bool append_raw(char *buf, size_t size, size_t *pos, const char *text)
+{
+    size_t len = strlen(text);
+    if (*pos + len >= size) {
+        return false;
+    }
+    memcpy(buf + *pos, text, len + 1);
+    *pos += len;
+    return true;
+}
+
+/**
+ * Format a status document
+ */
+size_t status_publish_format(char *buf, size_t size, const update_status_t *status, uint32_t fields)
+{
+    char number[32];
+    size_t pos = 0;
+    bool first = true;
+    bool ok = true;
+
+#define APPEND_KEY(name) \
+    ok = ok && append_raw(buf, size, &pos, first ? "\n    \"" name "\": " : ",\n    \"" name "\": "); \
+    first = false
+
+    ok = append_raw(buf, size, &pos, "{");
+    if (fields & UPDATE_FIELD_ID) {
+        APPEND_KEY("id");
+        ok = ok && append_string(buf, size, &pos, status->id);
+    }
+    if (fields & UPDATE_FIELD_PROGRESS) {
+        APPEND_KEY("progress");
+        snprintf(number, sizeof(number), "%d", status->progress);
+        ok = ok && append_raw(buf, size, &pos, number);
+    }
+    if (fields & UPDATE_FIELD_STATUS) {
+        APPEND_KEY("status");
+        ok = ok && append_string(buf, size, &pos, status->status);
+    }
+    if (fields & UPDATE_FIELD_STEP) {
+        APPEND_KEY("step");
+        ok = ok && append_string(buf, size, &pos, status->step);
+    }
+    if (fields & UPDATE_FIELD_ETA) {
+        APPEND_KEY("eta");
+        snprintf(number, sizeof(number), "%ld", (long)status->eta);
+        ok = ok && append_raw(buf, size, &pos, number);
+    }
+    if (fields & UPDATE_FIELD_BYTES_DONE) {
+        APPEND_KEY("bytes_done");
+        snprintf(number, sizeof(number), "%lld", (long long)status->bytes_done);
+        ok = ok && append_raw(buf, size, &pos, number);
+    }
+    if (fields & UPDATE_FIELD_BYTES_TOTAL) {
+        APPEND_KEY("bytes_total");
+        snprintf(number, sizeof(number), "%lld", (long long)status->bytes_total);
+        ok = ok && append_raw(buf, size, &pos, number);
+    }
+    if (fields & UPDATE_FIELD_COMPONENT) {
+        APPEND_KEY("component");
+        ok = ok && append_string(buf, size, &pos, status->component);
+    }
+    if (fields & UPDATE_FIELD_ERROR_CODE) {
+        APPEND_KEY("error_code");
+        snprintf(number, sizeof(number), "%ld", (long)status->error_code);
+        ok = ok && append_raw(buf, size, &pos, number);
+    }
+    if (fields & UPDATE_FIELD_SEQ) {
+        APPEND_KEY("seq");
+        snprintf(number, sizeof(number), "%ld", (long)status->seq);
+        ok = ok && append_raw(buf, size, &pos, number);
+    }
+    ok = ok && append_raw(buf, size, &pos, "\n}\n");
+
+#undef APPEND_KEY
+
+    return ok ? pos : 0;
+}
+
+/**
+ * Format a status document and atomically publish it
+ */
+bool status_publish(const char *path, const update_status_t *status, uint32_t fields)
+{
+    char doc[1024];
+    size_t len = status_publish_format(doc, sizeof(doc), status, fields);
+
+    if (len == 0) {
+        return false;
+    }
+    return status_publish_write(path, doc, len);
+}
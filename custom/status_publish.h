@@ -0,0 +1,56 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+/*
+ * Producer side helpers for the status file.
+ * The document is written to a temporary file in the same directory and
+ * renamed over the status file, so the tracker never sees a partial write.
+ * This module has no LVGL dependency and can be built into updater agents.
+ */
+
+#ifndef STATUS_PUBLISH_H_
+#define STATUS_PUBLISH_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "update_status.h"
+
+/**
+ * Atomically replace a file with new content.
+ * @param path file to replace
+ * @param data new content
+ * @param len length of data in bytes
+ * @return true on success; on failure the old file is left as it was
+ */
+bool status_publish_write(const char *path, const char *data, size_t len);
+
+/**
+ * Format a status document.
+ * @param buf output buffer
+ * @param size size of buf
+ * @param status values to write
+ * @param fields UPDATE_FIELD_* bits of the fields to include
+ * @return length of the document, 0 if it does not fit into buf
+ */
+size_t status_publish_format(char *buf, size_t size, const update_status_t *status, uint32_t fields);
+
+/**
+ * Format a status document and atomically publish it to path.
+ * @return true on success
+ */
+bool status_publish(const char *path, const update_status_t *status, uint32_t fields);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_PUBLISH_H_ */
@@ -0,0 +1,186 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "tracker_conf.h"
+#include "tracker_log.h"
+#include "status_watch.h"
+
+#if UPDATE_TRACKER_USE_INOTIFY
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <limits.h>
+    #include <unistd.h>
+    #include <sys/inotify.h>
+#endif
+
+#if UPDATE_TRACKER_USE_INOTIFY
+
+/*********************
+ *      DEFINES
+ *********************/
+#define WATCH_DIR_MASK  (IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int watch_fd = -1;                 // inotify instance
+static int watch_wd = -1;                 // watch on the parent directory
+static char watch_name[NAME_MAX + 1];     // file name inside the watched directory
+
+/**
+ * Stop watching and release the descriptor
+ */
+void status_watch_deinit(void)
+{
+    if (watch_fd >= 0) {
+        close(watch_fd);
+    }
+    watch_fd = -1;
+    watch_wd = -1;
+    watch_name[0] = '\0';
+}
+
+/**
+ * Start watching the parent directory of filepath
+ */
+bool status_watch_init(const char *filepath)
+{
+    char dir[PATH_MAX];
+    const char *slash = strrchr(filepath, '/');
+
+    status_watch_deinit();
+
+    // Split the path into the watched directory and the file name
+    if (slash == NULL) {
+        strcpy(dir, ".");
+        snprintf(watch_name, sizeof(watch_name), "%s", filepath);
+    } else {
+        size_t dir_len = (size_t)(slash - filepath);
+        if (dir_len == 0) {
+            dir_len = 1;  // file in "/"
+        }
+        if (dir_len >= sizeof(dir)) {
+            return false;
+        }
+        memcpy(dir, filepath, dir_len);
+        dir[dir_len] = '\0';
+        snprintf(watch_name, sizeof(watch_name), "%s", slash + 1);
+    }
+
+    watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch_fd < 0) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: inotify unavailable (%s), polling instead\n", strerror(errno));
+        return false;
+    }
+
+    watch_wd = inotify_add_watch(watch_fd, dir, WATCH_DIR_MASK);
+    if (watch_wd < 0) {
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Cannot watch %s (%s), polling instead\n", dir, strerror(errno));
+        status_watch_deinit();
+        return false;
+    }
+
+    return true;
+}
+
+bool status_watch_is_active(void)
+{
+    return watch_fd >= 0;
+}
+
+int status_watch_get_fd(void)
+{
+    return watch_fd;
+}
+
+/**
+ * Drain pending inotify events and report whether the status file changed
+ */
+bool status_watch_process(void)
+{
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    bool lost = false;
+
+    if (watch_fd < 0) {
+        return false;
+    }
+
+    for (;;) {
+        ssize_t len = read(watch_fd, events, sizeof(events));
+        if (len <= 0) {
+            if (len < 0 && errno == EINTR) {
+                continue;
+            }
+            break;  // EAGAIN: queue drained
+        }
+
+        for (char *p = events; p < events + len; ) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                // Events were dropped, assume our file was among them
+                changed = true;
+            } else if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                lost = true;
+            } else if ((ev->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) &&
+                       ev->len > 0 && strcmp(ev->name, watch_name) == 0) {
+                changed = true;
+            }
+
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+
+    if (lost) {
+        // The directory is gone, the caller has to fall back to polling
+        TRACKER_LOG(TRACKER_LOG_WARN, "Update tracker: Watched directory removed, polling instead\n");
+        status_watch_deinit();
+        changed = true;
+    }
+
+    return changed;
+}
+
+#else /* UPDATE_TRACKER_USE_INOTIFY */
+
+/* No file notification support on this platform: callers keep polling */
+
+bool status_watch_init(const char *filepath)
+{
+    (void)filepath;
+    return false;
+}
+
+bool status_watch_is_active(void)
+{
+    return false;
+}
+
+int status_watch_get_fd(void)
+{
+    return -1;
+}
+
+bool status_watch_process(void)
+{
+    return false;
+}
+
+void status_watch_deinit(void)
+{
+}
+
+#endif /* UPDATE_TRACKER_USE_INOTIFY */
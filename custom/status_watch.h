@@ -0,0 +1,53 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+#ifndef STATUS_WATCH_H_
+#define STATUS_WATCH_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+/**
+ * Start watching a file for completed writes and renames into place.
+ * The parent directory is watched, so the file does not have to exist yet.
+ * @param filepath file to watch
+ * @return true if event driven watching is active, false if the caller has to poll
+ */
+bool status_watch_init(const char *filepath);
+
+/**
+ * @return true while event driven watching is active
+ */
+bool status_watch_is_active(void);
+
+/**
+ * Get the descriptor that becomes readable when watch events are pending.
+ * @return file descriptor or -1 if no watcher is active
+ */
+int status_watch_get_fd(void);
+
+/**
+ * Drain all pending watch events without blocking.
+ * If the watched directory goes away the watcher shuts down and
+ * status_watch_is_active() returns false afterwards.
+ * @return true if the watched file was written or replaced (or may have been)
+ */
+bool status_watch_process(void);
+
+/**
+ * Stop watching and release the descriptor.
+ */
+void status_watch_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STATUS_WATCH_H_ */
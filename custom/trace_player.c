@@ -0,0 +1,252 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "trace_player.h"
+#include "status_publish.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BUILTIN_DELAY   3000    // ms between the steps of the built-in cycle
+#define MAX_LINE_LEN    (TRACE_PLAYER_MAX_DOC + 16)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t delay;     // ms since the previous write
+    uint32_t offset;    // document start in trace_text
+    uint32_t len;
+} trace_entry_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static char *trace_text;
+static trace_entry_t *trace_entries;
+static uint32_t trace_cnt = 0;
+static uint32_t trace_cap = 0;
+static size_t text_len = 0;
+static size_t text_cap = 0;
+
+/* Replay state */
+static lv_timer_t *play_timer;
+static const char *play_path;
+static uint32_t play_period;
+static uint32_t play_next = 0;
+
+static const char *const builtin_steps[] = {
+    "Preparing for update",
+    "Downloading packages",
+    "Verifying download",
+    "Installing updates",
+    "Configuring system",
+    "Finalizing installation",
+    "Cleaning up",
+    "Update complete."
+};
+
+/**
+ * Append one write to the trace, growing the buffers as needed
+ */
+static bool add_entry(uint32_t delay, const char *doc, size_t len)
+{
+    if (trace_cnt == trace_cap) {
+        uint32_t cap = trace_cap ? trace_cap * 2 : 16;
+        trace_entry_t *entries = lv_realloc(trace_entries, cap * sizeof(trace_entry_t));
+        if (entries == NULL) {
+            return false;
+        }
+        trace_entries = entries;
+        trace_cap = cap;
+    }
+    if (text_len + len > text_cap) {
+        size_t cap = text_cap ? text_cap * 2 : 4096;
+        while (cap < text_len + len) {
+            cap *= 2;
+        }
+        char *text = lv_realloc(trace_text, cap);
+        if (text == NULL) {
+            return false;
+        }
+        trace_text = text;
+        text_cap = cap;
+    }
+
+    memcpy(trace_text + text_len, doc, len);
+    trace_entries[trace_cnt].delay = delay;
+    trace_entries[trace_cnt].offset = (uint32_t)text_len;
+    trace_entries[trace_cnt].len = (uint32_t)len;
+    trace_cnt++;
+    text_len += len;
+    return true;
+}
+
+bool trace_player_load(const char *path)
+{
+    char line[MAX_LINE_LEN];
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL) {
+        printf("Error: Cannot open trace %s\n", path);
+        return false;
+    }
+    trace_player_unload();
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char *doc;
+        unsigned long delay = strtoul(line, &doc, 10);
+        size_t len;
+
+        if (line[0] == '#' || doc == line) {
+            continue;
+        }
+        while (*doc == ' ' || *doc == '\t') {
+            doc++;
+        }
+        len = strcspn(doc, "\r\n");
+        if (len == 0 || len >= TRACE_PLAYER_MAX_DOC) {
+            continue;
+        }
+        if (!add_entry((uint32_t)delay, doc, len)) {
+            break;
+        }
+    }
+    fclose(f);
+
+    return trace_cnt > 0;
+}
+
+bool trace_player_load_builtin(void)
+{
+    const uint32_t step_cnt = sizeof(builtin_steps) / sizeof(builtin_steps[0]);
+    char doc[256];
+
+    trace_player_unload();
+    for (uint32_t i = 0; i < step_cnt; i++) {
+        int len = snprintf(doc, sizeof(doc),
+                           "{\"progress\": %u, \"status\": \"System Updating...\", \"step\": \"%s\"}",
+                           (unsigned)(i * 100 / step_cnt), builtin_steps[i]);
+        if (!add_entry(BUILTIN_DELAY, doc, (size_t)len)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void trace_player_unload(void)
+{
+    lv_free(trace_text);
+    lv_free(trace_entries);
+    trace_text = NULL;
+    trace_entries = NULL;
+    trace_cnt = trace_cap = 0;
+    text_len = text_cap = 0;
+    play_next = 0;
+}
+
+uint32_t trace_player_get_count(void)
+{
+    return trace_cnt;
+}
+
+uint32_t trace_player_get_delay(uint32_t index)
+{
+    return index < trace_cnt ? trace_entries[index].delay : 0;
+}
+
+size_t trace_player_format(uint32_t index, uint32_t seq, char *buf, size_t size)
+{
+    const trace_entry_t *e;
+    const char *doc;
+    size_t pos = 0;
+    int n;
+
+    if (index >= trace_cnt) {
+        return 0;
+    }
+    e = &trace_entries[index];
+    doc = trace_text + e->offset;
+
+    if (seq == 0 || doc[0] != '{') {
+        if (e->len + 2 > size) {
+            return 0;
+        }
+        memcpy(buf, doc, e->len);
+        pos = e->len;
+    } else {
+        // Put the sequence number first, the rest of the object follows unchanged
+        const char *rest = doc + 1;
+        size_t rest_len = e->len - 1;
+        size_t i = 0;
+        while (i < rest_len && (rest[i] == ' ' || rest[i] == '\t')) {
+            i++;
+        }
+        n = snprintf(buf, size, "{\"seq\": %u%s", (unsigned)seq, i < rest_len && rest[i] == '}' ? "" : ", ");
+        if (n < 0 || (size_t)n + rest_len + 2 > size) {
+            return 0;
+        }
+        memcpy(buf + n, rest, rest_len);
+        pos = (size_t)n + rest_len;
+    }
+    buf[pos++] = '\n';
+    buf[pos] = '\0';
+    return pos;
+}
+
+bool trace_player_write(const char *path, uint32_t index, uint32_t seq)
+{
+    char doc[TRACE_PLAYER_MAX_DOC + 32];
+    size_t len = trace_player_format(index, seq, doc, sizeof(doc));
+
+    return len > 0 && status_publish_write(path, doc, len);
+}
+
+/**
+ * Write the next document and wait as long as the trace says
+ */
+static void play_timer_cb(lv_timer_t *timer)
+{
+    if (trace_cnt == 0) {
+        return;
+    }
+    if (play_next >= trace_cnt) {
+        play_next = 0;  // cycle completed, start over
+    }
+    trace_player_write(play_path, play_next, 0);
+    play_next++;
+
+    if (play_period == 0) {
+        uint32_t delay = trace_player_get_delay(play_next < trace_cnt ? play_next : 0);
+        lv_timer_set_period(timer, delay > 0 ? delay : 1);
+    }
+}
+
+void trace_player_start(const char *path, uint32_t period_ms)
+{
+    play_path = path;
+    play_period = period_ms;
+    play_next = 0;
+
+    if (play_timer == NULL) {
+        uint32_t first = period_ms ? period_ms : trace_player_get_delay(0);
+        play_timer = lv_timer_create(play_timer_cb, first > 0 ? first : 1, NULL);
+    } else if (period_ms) {
+        lv_timer_set_period(play_timer, period_ms);
+    }
+}
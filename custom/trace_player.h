@@ -0,0 +1,70 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+#ifndef TRACE_PLAYER_H_
+#define TRACE_PLAYER_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TRACE_PLAYER_MAX_DOC 1024
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Load a recorded trace of status writes. One write per line:
+ *  <ms since the previous write> <status JSON document>
+ * Empty lines and lines starting with '#' are ignored.
+ * @return false if the file can't be read or holds no write
+ */
+bool trace_player_load(const char *path);
+
+/**
+ * Load the built-in update cycle: eight steps from preparing to complete, 3 s apart
+ */
+bool trace_player_load_builtin(void);
+
+void trace_player_unload(void);
+uint32_t trace_player_get_count(void);
+
+/**
+ * Get the recorded delay of a write, in ms since the previous one
+ */
+uint32_t trace_player_get_delay(uint32_t index);
+
+/**
+ * Format a write of the trace, with "seq" added when seq is not 0
+ * @return length of the document, 0 if it does not fit
+ */
+size_t trace_player_format(uint32_t index, uint32_t seq, char *buf, size_t size);
+
+/**
+ * Atomically publish a write of the trace to the status file
+ */
+bool trace_player_write(const char *path, uint32_t index, uint32_t seq);
+
+/**
+ * Replay the loaded trace into the status file, looping forever
+ * @param period_ms time between writes, 0 to use the recorded delays
+ */
+void trace_player_start(const char *path, uint32_t period_ms);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TRACE_PLAYER_H_ */
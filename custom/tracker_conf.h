@@ -0,0 +1,292 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+/*
+ * tracker_conf.h - build time configuration of the update tracker.
+ * Every option can be overridden from the compiler command line, e.g.
+ *  -DUPDATE_TRACKER_USE_INOTIFY=0
+ */
+
+#ifndef TRACKER_CONF_H_
+#define TRACKER_CONF_H_
+
+/*********************
+ *      PLATFORM
+ *********************/
+/* Check if we're compiling for simulator mode */
+#if defined(SIMULATOR) || defined(BUILD_SIMULATOR) || (!defined(__linux__) && !defined(CONFIG_ZEPHYR_LVGL) && !defined(CONFIG_ZEPHYR_KERNEL))
+    #define IS_SIMULATOR 1
+#else
+    #define IS_SIMULATOR 0
+#endif
+
+#if defined(CONFIG_ZEPHYR_LVGL) || defined(CONFIG_ZEPHYR_KERNEL)
+    #define IS_ZEPHYR 1
+#else
+    #define IS_ZEPHYR 0
+#endif
+
+/*********************
+ *      PATHS
+ *********************/
+#ifndef UPDATE_JSON_PATH
+    #if IS_SIMULATOR
+        /* For simulator, use a path in the current directory */
+        #define UPDATE_JSON_PATH "current_update_step.json"
+    #elif IS_ZEPHYR
+        #define UPDATE_JSON_PATH "/tmp/current_update_step.json"
+    #else
+        /* For real targets (Yocto, etc.), use appropriate path */
+        #define UPDATE_JSON_PATH "/var/lib/update_tracker/current_update_step.json"
+    #endif
+#endif
+
+#ifndef UPDATE_BINARY_PATH
+    /* Binary status record, see status_binary.h */
+    #if IS_SIMULATOR
+        #define UPDATE_BINARY_PATH "current_update_step.bin"
+    #else
+        #define UPDATE_BINARY_PATH "/run/update_tracker/status.bin"
+    #endif
+#endif
+
+#ifndef UPDATE_SOCKET_PATH
+    #if IS_SIMULATOR
+        #define UPDATE_SOCKET_PATH "update_tracker.sock"
+    #else
+        #define UPDATE_SOCKET_PATH "/run/update_tracker/status.sock"
+    #endif
+#endif
+
+#ifndef UPDATE_JOBS_PATH
+    /* A multi-job document, or a directory holding one document per job */
+    #if IS_SIMULATOR
+        #define UPDATE_JOBS_PATH "update_jobs"
+    #else
+        #define UPDATE_JOBS_PATH "/var/lib/update_tracker/jobs"
+    #endif
+#endif
+
+#ifndef UPDATE_TRACKER_HISTORY_PATH
+    /* Timeline of the statuses received, written when an update fails */
+    #if IS_SIMULATOR
+        #define UPDATE_TRACKER_HISTORY_PATH "update_tracker_history.txt"
+    #else
+        #define UPDATE_TRACKER_HISTORY_PATH "/run/update_tracker/history.txt"
+    #endif
+#endif
+
+#ifndef UPDATE_TRACKER_STATS_PATH
+    #if IS_SIMULATOR
+        #define UPDATE_TRACKER_STATS_PATH "update_tracker_stats.txt"
+    #else
+        #define UPDATE_TRACKER_STATS_PATH "/run/update_tracker/stats.txt"
+    #endif
+#endif
+
+#ifndef UPDATE_TRACKER_METRICS_PATH
+    #if IS_SIMULATOR
+        #define UPDATE_TRACKER_METRICS_PATH "update_tracker.prom"
+    #else
+        #define UPDATE_TRACKER_METRICS_PATH "/run/update_tracker/metrics.prom"
+    #endif
+#endif
+
+/*********************
+ *      OPTIONS
+ *********************/
+/* Watch the status file with inotify instead of polling it (Linux only) */
+#ifndef UPDATE_TRACKER_USE_INOTIFY
+    #if defined(__linux__) && !IS_ZEPHYR
+        #define UPDATE_TRACKER_USE_INOTIFY 1
+    #else
+        #define UPDATE_TRACKER_USE_INOTIFY 0
+    #endif
+#endif
+
+/* Watch, read and parse the status file on a thread of its own (POSIX only) */
+#ifndef UPDATE_TRACKER_USE_INGEST_THREAD
+    #if defined(__unix__) && !IS_ZEPHYR
+        #define UPDATE_TRACKER_USE_INGEST_THREAD 1
+    #else
+        #define UPDATE_TRACKER_USE_INGEST_THREAD 0
+    #endif
+#endif
+
+/* Accept status documents pushed over a Unix datagram socket (POSIX only) */
+#ifndef UPDATE_TRACKER_USE_SOCKET
+    #if defined(__unix__) && !IS_ZEPHYR
+        #define UPDATE_TRACKER_USE_SOCKET 1
+    #else
+        #define UPDATE_TRACKER_USE_SOCKET 0
+    #endif
+#endif
+
+/* Permissions of the ingest socket, whatever the umask: connecting needs write access */
+#ifndef UPDATE_TRACKER_SOCKET_MODE
+    #define UPDATE_TRACKER_SOCKET_MODE 0660
+#endif
+
+/* Datagrams of the ingest socket handled per call, the rest wait for the next loop pass */
+#ifndef UPDATE_TRACKER_SOCKET_BURST
+    #define UPDATE_TRACKER_SOCKET_BURST 16
+#endif
+
+/* Accept binary statuses posted to a k_msgq by other threads (Zephyr only) */
+#ifndef UPDATE_TRACKER_USE_MSGQ
+    #define UPDATE_TRACKER_USE_MSGQ IS_ZEPHYR
+#endif
+
+/* Statuses the message queue holds until the LVGL thread drains it */
+#ifndef UPDATE_TRACKER_MSGQ_DEPTH
+    #define UPDATE_TRACKER_MSGQ_DEPTH 4
+#endif
+
+/* Read a memory mapped binary status record in addition to the JSON file (POSIX only) */
+#ifndef UPDATE_TRACKER_USE_BINARY
+    #define UPDATE_TRACKER_USE_BINARY 0
+#endif
+
+/* Show the newest of the statuses received between two frames only once */
+#ifndef UPDATE_TRACKER_COALESCE
+    #define UPDATE_TRACKER_COALESCE 1
+#endif
+
+/* Keep the statuses received in a ring, dumped to UPDATE_TRACKER_HISTORY_PATH on failure */
+#ifndef UPDATE_TRACKER_USE_HISTORY
+    #define UPDATE_TRACKER_USE_HISTORY 1
+#endif
+
+/* Statuses kept in the ring, a power of two */
+#ifndef UPDATE_TRACKER_HISTORY_LEN
+    #if IS_ZEPHYR
+        #define UPDATE_TRACKER_HISTORY_LEN 16
+    #else
+        #define UPDATE_TRACKER_HISTORY_LEN 64
+    #endif
+#endif
+
+/* Pre-compose the widgets that never change into one cached background image,
+ * costs one full screen buffer in the display's color format */
+#ifndef UPDATE_TRACKER_USE_STATIC_LAYER
+    #define UPDATE_TRACKER_USE_STATIC_LAYER 0
+#endif
+
+/* Flush the background and the logo before the update screen is built */
+#ifndef UPDATE_TRACKER_USE_SPLASH
+    #define UPDATE_TRACKER_USE_SPLASH 1
+#endif
+
+/* Move the loading bar from progress samples, redrawing only the strip that changed */
+#ifndef UPDATE_TRACKER_USE_PROGRESS_ENGINE
+    #define UPDATE_TRACKER_USE_PROGRESS_ENGINE 1
+#endif
+
+/* Highest frame rate of the loading bar, and how long it takes to catch up with a jump */
+#ifndef PROGRESS_ENGINE_FPS
+    #define PROGRESS_ENGINE_FPS 30
+#endif
+
+#ifndef PROGRESS_ENGINE_EASE_MS
+    #define PROGRESS_ENGINE_EASE_MS 250
+#endif
+
+/* Poll the status file at an interval that follows its activity, when it can't be watched */
+#ifndef UPDATE_TRACKER_POLL_ADAPTIVE
+    #define UPDATE_TRACKER_POLL_ADAPTIVE 1
+#endif
+
+/* Interval in ms right after a change, kept for UPDATE_TRACKER_POLL_HOLD polls */
+#ifndef UPDATE_TRACKER_POLL_FAST_MS
+    #define UPDATE_TRACKER_POLL_FAST_MS 100
+#endif
+
+#ifndef UPDATE_TRACKER_POLL_HOLD
+    #define UPDATE_TRACKER_POLL_HOLD 10
+#endif
+
+/* Ceilings in ms of the exponential back-off, while an update runs and while the unit is idle */
+#ifndef UPDATE_TRACKER_POLL_ACTIVE_MAX_MS
+    #define UPDATE_TRACKER_POLL_ACTIVE_MAX_MS 1000
+#endif
+
+#ifndef UPDATE_TRACKER_POLL_IDLE_MAX_MS
+    #define UPDATE_TRACKER_POLL_IDLE_MAX_MS 30000
+#endif
+
+/* Show the concurrent updates of UPDATE_JOBS_PATH in a list below the main progress */
+#ifndef UPDATE_TRACKER_USE_JOBS
+    #define UPDATE_TRACKER_USE_JOBS 0
+#endif
+
+/* Period in ms of checking UPDATE_JOBS_PATH for changes */
+#ifndef UPDATE_TRACKER_JOBS_INTERVAL
+    #define UPDATE_TRACKER_JOBS_INTERVAL 1000
+#endif
+
+/* Jobs kept at most, the others are ignored */
+#ifndef UPDATE_TRACKER_MAX_JOBS
+    #define UPDATE_TRACKER_MAX_JOBS 256
+#endif
+
+/* Write UPDATE_TRACKER_METRICS_PATH in the Prometheus text format for fleet monitoring */
+#ifndef UPDATE_TRACKER_USE_METRICS
+    #define UPDATE_TRACKER_USE_METRICS 0
+#endif
+
+/* Period in ms of rewriting UPDATE_TRACKER_METRICS_PATH */
+#ifndef UPDATE_TRACKER_METRICS_INTERVAL
+    #define UPDATE_TRACKER_METRICS_INTERVAL 15000
+#endif
+
+/* Suspend the display refresh while the screen is static */
+#ifndef UPDATE_TRACKER_USE_IDLE
+    #define UPDATE_TRACKER_USE_IDLE 1
+#endif
+
+/* Time in ms without an invalidated area before the refresh is suspended */
+#ifndef UPDATE_TRACKER_IDLE_TIMEOUT
+    #define UPDATE_TRACKER_IDLE_TIMEOUT 5000
+#endif
+
+/* Format and write the log lines on a thread of their own (POSIX only), Zephyr has LOG_MODE_DEFERRED */
+#ifndef UPDATE_TRACKER_USE_ASYNC_LOG
+    #if defined(__unix__) && !IS_ZEPHYR
+        #define UPDATE_TRACKER_USE_ASYNC_LOG 1
+    #else
+        #define UPDATE_TRACKER_USE_ASYNC_LOG 0
+    #endif
+#endif
+
+/* Lines the log ring holds until they are written, a power of two */
+#ifndef UPDATE_TRACKER_LOG_DEPTH
+    #define UPDATE_TRACKER_LOG_DEPTH 64
+#endif
+
+/* Most verbose level logged: 0 errors, 1 warnings, 2 information, 3 debugging */
+#ifndef UPDATE_TRACKER_LOG_LEVEL
+    #define UPDATE_TRACKER_LOG_LEVEL 2
+#endif
+
+/* Keep the label texts in fixed buffers sized like update_status_t, they are never reallocated on the LVGL heap */
+#ifndef UPDATE_TRACKER_STATIC_LABELS
+    #define UPDATE_TRACKER_STATIC_LABELS 1
+#endif
+
+/* Timing histograms of the update path and the display, dumped on SIGUSR1; the metrics need them */
+#ifndef UPDATE_TRACKER_USE_STATS
+    #define UPDATE_TRACKER_USE_STATS UPDATE_TRACKER_USE_METRICS
+#endif
+
+/* Period in ms of rewriting UPDATE_TRACKER_STATS_PATH, 0 to only dump on request */
+#ifndef UPDATE_TRACKER_STATS_INTERVAL
+    #define UPDATE_TRACKER_STATS_INTERVAL 10000
+#endif
+
+#endif /* TRACKER_CONF_H_ */
@@ -0,0 +1,475 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "tracker_conf.h"
+#include "tracker_log.h"
+#include "tracker_stats.h"
+
+#if UPDATE_TRACKER_USE_ASYNC_LOG
+    #include <pthread.h>
+    #include <semaphore.h>
+    #include <stdatomic.h>
+    #include <stdlib.h>
+    #include <unistd.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LOG_MASK        (UPDATE_TRACKER_LOG_DEPTH - 1)
+#define LINE_LEN        512
+#define SPEC_LEN        24
+#define FLUSH_WAIT_US   1000
+#define FLUSH_WAIT_MAX  200         // give up on a stuck console after 200 ms
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+#if UPDATE_TRACKER_USE_ASYNC_LOG
+typedef enum {
+    ARG_END,                        // end of the format string
+    ARG_LITERAL,                    // %%
+    ARG_SIGNED,
+    ARG_UNSIGNED,
+    ARG_DOUBLE,
+    ARG_STRING,
+    ARG_POINTER,
+    ARG_UNSUPPORTED,                // * width, %n, long double: printed as is
+} arg_kind_t;
+
+typedef enum {
+    LEN_HH, LEN_H, LEN_NONE, LEN_L, LEN_LL, LEN_Z, LEN_J, LEN_T,
+} arg_len_t;
+
+/* One conversion of a format string */
+typedef struct {
+    arg_kind_t kind;
+    arg_len_t len;
+    const char *start;              // the '%'
+    const char *end;                // after the conversion character
+} spec_t;
+
+typedef union {
+    long long i;
+    double d;
+    const void *p;
+    size_t text;                    // offset of a copied string in the slot text
+} log_arg_t;
+
+typedef struct {
+    atomic_uint seq;                // sequence of the ring position the slot holds
+    const tracker_log_site_t *site;
+    uint64_t time_us;
+    uint32_t suppressed;
+    log_arg_t args[TRACKER_LOG_MAX_ARGS];
+    char text[TRACKER_LOG_TEXT_LEN];
+} log_slot_t;
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if UPDATE_TRACKER_USE_ASYNC_LOG
+static log_slot_t ring[UPDATE_TRACKER_LOG_DEPTH];
+static atomic_uint ring_head;       // next position a producer reserves
+static unsigned int ring_tail;      // next position the flusher reads
+static atomic_uint ring_done;       // positions written out
+static atomic_uint dropped;         // lines lost to a full ring
+static sem_t wake;
+static pthread_once_t start_once = PTHREAD_ONCE_INIT;
+static bool async = false;
+#endif
+
+/**
+ * Apply the rate limit of a site
+ * @return false to drop the line, else the lines suppressed before it are in *suppressed
+ */
+static bool site_admit(tracker_log_site_t *site, uint32_t now_ms, uint32_t *suppressed)
+{
+    if (site->interval_ms && site->last_ms && now_ms - site->last_ms < site->interval_ms) {
+        site->suppressed++;
+        return false;
+    }
+    site->last_ms = now_ms ? now_ms : 1;
+    *suppressed = site->suppressed;
+    site->suppressed = 0;
+    return true;
+}
+
+#if UPDATE_TRACKER_USE_ASYNC_LOG
+
+/**
+ * Find the next conversion of a format string
+ * @return the character after it, where the search goes on
+ */
+static const char *next_spec(const char *fmt, spec_t *spec)
+{
+    const char *p = strchr(fmt, '%');
+
+    spec->len = LEN_NONE;
+    if (p == NULL) {
+        spec->kind = ARG_END;
+        spec->start = spec->end = fmt + strlen(fmt);
+        return spec->end;
+    }
+    spec->start = p++;
+    p += strspn(p, "-+ #0'");
+    p += strspn(p, "0123456789");
+    if (*p == '.') {
+        p++;
+        p += strspn(p, "0123456789");
+    }
+    if (*p == '*' || (p[-1] == '.' && p[-2] == '*')) {
+        spec->kind = ARG_UNSUPPORTED;
+        spec->end = p;
+        return p;
+    }
+
+    switch (*p) {
+        case 'h':
+            spec->len = (p[1] == 'h') ? LEN_HH : LEN_H;
+            p += (p[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            spec->len = (p[1] == 'l') ? LEN_LL : LEN_L;
+            p += (p[1] == 'l') ? 2 : 1;
+            break;
+        case 'z': spec->len = LEN_Z; p++; break;
+        case 'j': spec->len = LEN_J; p++; break;
+        case 't': spec->len = LEN_T; p++; break;
+        case 'L': spec->kind = ARG_UNSUPPORTED; spec->end = p; return p;
+        default: break;
+    }
+
+    switch (*p) {
+        case 'd': case 'i': case 'c':
+            spec->kind = ARG_SIGNED;
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            spec->kind = ARG_UNSIGNED;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec->kind = ARG_DOUBLE;
+            break;
+        case 's': spec->kind = ARG_STRING; break;
+        case 'p': spec->kind = ARG_POINTER; break;
+        case '%': spec->kind = ARG_LITERAL; break;
+        default:
+            spec->kind = ARG_UNSUPPORTED;
+            spec->end = p;
+            return p;
+    }
+    spec->end = ++p;
+    return p;
+}
+
+static long long read_signed(va_list *ap, arg_len_t len)
+{
+    switch (len) {
+        case LEN_HH: return (signed char)va_arg(*ap, int);
+        case LEN_H: return (short)va_arg(*ap, int);
+        case LEN_L: return va_arg(*ap, long);
+        case LEN_LL: return va_arg(*ap, long long);
+        case LEN_Z: case LEN_T: return va_arg(*ap, ptrdiff_t);
+        case LEN_J: return va_arg(*ap, intmax_t);
+        default: return va_arg(*ap, int);
+    }
+}
+
+static long long read_unsigned(va_list *ap, arg_len_t len)
+{
+    switch (len) {
+        case LEN_HH: return (unsigned char)va_arg(*ap, unsigned int);
+        case LEN_H: return (unsigned short)va_arg(*ap, unsigned int);
+        case LEN_L: return (long long)va_arg(*ap, unsigned long);
+        case LEN_LL: return (long long)va_arg(*ap, unsigned long long);
+        case LEN_Z: return (long long)va_arg(*ap, size_t);
+        case LEN_T: return va_arg(*ap, ptrdiff_t);
+        case LEN_J: return (long long)va_arg(*ap, uintmax_t);
+        default: return va_arg(*ap, unsigned int);
+    }
+}
+
+/**
+ * Copy the arguments of a line into its slot, the strings into the slot text
+ */
+static void record_args(log_slot_t *slot, const char *fmt, va_list *ap)
+{
+    size_t text_used = 0;
+    spec_t spec;
+    int n = 0;
+
+    for (fmt = next_spec(fmt, &spec); spec.kind != ARG_END && spec.kind != ARG_UNSUPPORTED;
+         fmt = next_spec(fmt, &spec)) {
+        log_arg_t *arg = &slot->args[n];
+        const char *s;
+        size_t len;
+
+        if (spec.kind == ARG_LITERAL) {
+            continue;
+        }
+        if (n == TRACKER_LOG_MAX_ARGS) {
+            break;
+        }
+        switch (spec.kind) {
+            case ARG_SIGNED: arg->i = read_signed(ap, spec.len); break;
+            case ARG_UNSIGNED: arg->i = read_unsigned(ap, spec.len); break;
+            case ARG_DOUBLE: arg->d = va_arg(*ap, double); break;
+            case ARG_POINTER: arg->p = va_arg(*ap, const void *); break;
+            case ARG_STRING:
+                s = va_arg(*ap, const char *);
+                s = s ? s : "(null)";
+                len = strlen(s);
+                // Strings that don't fit are cut, the ones past the end of the text are empty
+                if (text_used < sizeof(slot->text)) {
+                    len = (len < sizeof(slot->text) - text_used) ? len : sizeof(slot->text) - text_used - 1;
+                    memcpy(&slot->text[text_used], s, len);
+                    slot->text[text_used + len] = '\0';
+                    arg->text = text_used;
+                    text_used += len + 1;
+                } else {
+                    arg->text = sizeof(slot->text) - 1;
+                }
+                break;
+            default:
+                break;
+        }
+        n++;
+    }
+}
+
+/**
+ * Format a slot the way printf would have formatted the call
+ */
+static size_t format_slot(const log_slot_t *slot, char *line, size_t size)
+{
+    const char *fmt = slot->site->fmt;
+    size_t pos = 0;
+    spec_t spec;
+    int n = 0;
+
+#define APPEND(...) do { \
+        int len_ = snprintf(&line[pos], size - pos, __VA_ARGS__); \
+        if (len_ > 0) pos += ((size_t)len_ < size - pos) ? (size_t)len_ : size - pos - 1; \
+    } while (0)
+
+    APPEND("[%5u.%03u] ", (unsigned)(slot->time_us / 1000000), (unsigned)(slot->time_us / 1000 % 1000));
+    for (;;) {
+        const char *next = next_spec(fmt, &spec);
+        char conv[SPEC_LEN];
+        size_t spec_len;
+
+        APPEND("%.*s", (int)(spec.start - fmt), fmt);
+        if (spec.kind == ARG_END) {
+            break;
+        }
+        if (spec.kind == ARG_UNSUPPORTED || n == TRACKER_LOG_MAX_ARGS) {
+            APPEND("%s", spec.start);
+            break;
+        }
+        if (spec.kind == ARG_LITERAL) {
+            APPEND("%%");
+            fmt = next;
+            continue;
+        }
+
+        // Keep flags, width and precision, the value itself is always recorded wide
+        spec_len = strspn(spec.start + 1, "-+ #0'123456789.") + 1;
+        if (spec_len + 3 >= sizeof(conv)) {
+            APPEND("%s", spec.start);
+            break;
+        }
+        memcpy(conv, spec.start, spec_len);
+        snprintf(&conv[spec_len], sizeof(conv) - spec_len, "%s%c",
+                 (spec.kind == ARG_SIGNED || spec.kind == ARG_UNSIGNED) && spec.end[-1] != 'c' ? "ll" : "",
+                 spec.end[-1]);
+        switch (spec.kind) {
+            case ARG_SIGNED:
+            case ARG_UNSIGNED:
+                if (spec.end[-1] == 'c') {
+                    APPEND(conv, (int)slot->args[n].i);
+                } else {
+                    APPEND(conv, slot->args[n].i);
+                }
+                break;
+            case ARG_DOUBLE: APPEND(conv, slot->args[n].d); break;
+            case ARG_POINTER: APPEND(conv, slot->args[n].p); break;
+            case ARG_STRING: APPEND(conv, &slot->text[slot->args[n].text]); break;
+            default: break;
+        }
+        n++;
+        fmt = next;
+    }
+
+    if (slot->suppressed) {
+        // Before the newline the message ends with
+        if (pos > 0 && line[pos - 1] == '\n') {
+            pos--;
+        }
+        APPEND(" (%u similar lines suppressed)\n", (unsigned)slot->suppressed);
+    }
+#undef APPEND
+    return pos;
+}
+
+/**
+ * Write the lines out as they come, the only place that blocks on stdout
+ */
+static void *flusher_main(void *arg)
+{
+    static char line[LINE_LEN];
+    unsigned int reported_drops = 0;
+
+    (void)arg;
+    for (;;) {
+        log_slot_t *slot = &ring[ring_tail & LOG_MASK];
+        unsigned int drops;
+
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != ring_tail + 1) {
+            fflush(stdout);
+            while (sem_wait(&wake) != 0) {
+            }
+            continue;
+        }
+
+        fwrite(line, 1, format_slot(slot, line, sizeof(line)), stdout);
+        atomic_store_explicit(&slot->seq, ring_tail + UPDATE_TRACKER_LOG_DEPTH, memory_order_release);
+        ring_tail++;
+
+        drops = atomic_load_explicit(&dropped, memory_order_relaxed);
+        if (drops != reported_drops) {
+            fprintf(stdout, "Update tracker: %u log lines lost to a full log ring\n", drops - reported_drops);
+            reported_drops = drops;
+        }
+        atomic_fetch_add_explicit(&ring_done, 1, memory_order_release);
+    }
+    return NULL;
+}
+
+static void flusher_start(void)
+{
+    pthread_t thread;
+    unsigned int i;
+
+    for (i = 0; i < UPDATE_TRACKER_LOG_DEPTH; i++) {
+        atomic_init(&ring[i].seq, i);
+    }
+    if (sem_init(&wake, 0, 0) != 0) {
+        return;
+    }
+    if (pthread_create(&thread, NULL, flusher_main, NULL) != 0) {
+        sem_destroy(&wake);
+        printf("Update tracker: Cannot start the log thread, logging synchronously\n");
+        return;
+    }
+    pthread_detach(thread);
+    async = true;
+    atexit(tracker_log_flush);
+}
+
+#endif /* UPDATE_TRACKER_USE_ASYNC_LOG */
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void tracker_log_write(tracker_log_site_t *site, const char *fmt, ...)
+{
+    uint64_t now_us = tracker_stats_now_us();
+    uint32_t suppressed;
+    va_list ap;
+
+    if (site->level > UPDATE_TRACKER_LOG_LEVEL || !site_admit(site, (uint32_t)(now_us / 1000), &suppressed)) {
+        return;
+    }
+
+#if UPDATE_TRACKER_USE_ASYNC_LOG
+    pthread_once(&start_once, flusher_start);
+    if (async) {
+        unsigned int pos = atomic_load_explicit(&ring_head, memory_order_relaxed);
+        log_slot_t *slot;
+
+        // Reserve a position, a full ring drops the line rather than wait for the console
+        for (;;) {
+            slot = &ring[pos & LOG_MASK];
+            int diff = (int)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (atomic_compare_exchange_weak_explicit(&ring_head, &pos, pos + 1,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+                return;
+            } else {
+                pos = atomic_load_explicit(&ring_head, memory_order_relaxed);
+            }
+        }
+
+        slot->site = site;
+        slot->time_us = now_us;
+        slot->suppressed = suppressed;
+        va_start(ap, fmt);
+        record_args(slot, fmt, &ap);
+        va_end(ap);
+        atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+        sem_post(&wake);
+        return;
+    }
+#endif
+
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    if (suppressed) {
+        printf("(%u similar lines suppressed)\n", (unsigned)suppressed);
+    }
+}
+
+void tracker_log_flush(void)
+{
+#if UPDATE_TRACKER_USE_ASYNC_LOG
+    unsigned int target = atomic_load_explicit(&ring_head, memory_order_acquire);
+    int i;
+
+    if (!async) {
+        fflush(stdout);
+        return;
+    }
+    for (i = 0; i < FLUSH_WAIT_MAX; i++) {
+        if ((int)(atomic_load_explicit(&ring_done, memory_order_acquire) - target) >= 0) {
+            break;
+        }
+        usleep(FLUSH_WAIT_US);
+    }
+    fflush(stdout);
+#else
+    fflush(stdout);
+#endif
+}
+
+uint32_t tracker_log_get_dropped(void)
+{
+#if UPDATE_TRACKER_USE_ASYNC_LOG
+    return atomic_load_explicit(&dropped, memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
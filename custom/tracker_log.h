@@ -0,0 +1,102 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+/*
+ * tracker_log - logging that never blocks the caller on stdout.
+ * A call records its call site, a timestamp and the raw arguments in a
+ * preallocated ring. A background thread formats and writes the lines, so a
+ * slow serial console or a full journald pipe only delays the log.
+ * Each call site can be rate limited:
+ *  TRACKER_LOG_EVERY(TRACKER_LOG_INFO, 10000, "Waiting for %s\n", path);
+ * logs at most every 10 s and reports how many lines it suppressed.
+ * The format is a format string literal; %s arguments are copied, up to
+ * TRACKER_LOG_TEXT_LEN bytes per line.
+ */
+
+#ifndef TRACKER_LOG_H_
+#define TRACKER_LOG_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "tracker_conf.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TRACKER_LOG_MAX_ARGS    8
+#define TRACKER_LOG_TEXT_LEN    160
+
+#if defined(__GNUC__)
+    #define TRACKER_LOG_PRINTF(fmt_idx, arg_idx) __attribute__((format(printf, fmt_idx, arg_idx)))
+#else
+    #define TRACKER_LOG_PRINTF(fmt_idx, arg_idx)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    TRACKER_LOG_ERROR,
+    TRACKER_LOG_WARN,
+    TRACKER_LOG_INFO,
+    TRACKER_LOG_DEBUG,
+} tracker_log_level_t;
+
+/* State of one call site, defined by the macros below */
+typedef struct {
+    const char *fmt;
+    uint8_t level;
+    uint32_t interval_ms;       // least time between two lines, 0 for none
+    uint32_t last_ms;           // when the site last logged
+    uint32_t suppressed;        // lines dropped by the rate limit since
+} tracker_log_site_t;
+
+/**********************
+ *      MACROS
+ **********************/
+#define TRACKER_LOG_FIRST_(first, ...) first
+
+/**
+ * Log a line at level, at most every interval_ms.
+ * Levels above UPDATE_TRACKER_LOG_LEVEL are compiled out.
+ */
+#define TRACKER_LOG_EVERY(level, interval_ms, ...) do { \
+        if ((level) <= UPDATE_TRACKER_LOG_LEVEL) { \
+            static tracker_log_site_t tracker_log_site_ = { TRACKER_LOG_FIRST_(__VA_ARGS__, 0), (level), (interval_ms), 0, 0 }; \
+            tracker_log_write(&tracker_log_site_, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define TRACKER_LOG(level, ...) TRACKER_LOG_EVERY(level, 0, __VA_ARGS__)
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Record a line for site. Use the macros, fmt must be site->fmt.
+ */
+void tracker_log_write(tracker_log_site_t *site, const char *fmt, ...) TRACKER_LOG_PRINTF(2, 3);
+
+/**
+ * Wait until the lines recorded so far are written
+ */
+void tracker_log_flush(void);
+
+/**
+ * Lines lost because the ring was full
+ */
+uint32_t tracker_log_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TRACKER_LOG_H_ */
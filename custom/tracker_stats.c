@@ -0,0 +1,508 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "tracker_conf.h"
+#include "tracker_stats.h"
+
+#if IS_ZEPHYR
+    #include <zephyr/kernel.h>
+#else
+    #include <time.h>
+#endif
+
+#if UPDATE_TRACKER_USE_STATS
+    #include "status_history.h"
+    #include "status_ingest.h"
+    #include "status_publish.h"
+    #include "tracker_log.h"
+    /* The invalidated areas of the frame are not exposed publicly */
+    #include "src/display/lv_display_private.h"
+    #if !IS_ZEPHYR && !defined(_WIN32) && !defined(_WIN64)
+        #include <errno.h>
+        #include <fcntl.h>
+        #include <signal.h>
+        #include <unistd.h>
+        #define HAVE_SIGUSR1 1
+    #endif
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define REPORT_SIZE         4096
+#define METRICS_SIZE        8192
+
+/**********************
+ * GLOBAL VARIABLES
+ **********************/
+tracker_counters_t tracker_counters;
+
+#if UPDATE_TRACKER_USE_STATS
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static tracker_hist_t hists[TRACKER_STAT_COUNT];
+static const char *const stat_names[TRACKER_STAT_COUNT] = {
+    "file_latency_us",
+    "parse_us",
+    "ingest_us",
+    "apply_us",
+    "render_us",
+    "flush_us",
+    "inv_area_px",
+};
+
+/* Prometheus names, in base units: seconds and pixels */
+static const char *const metric_names[TRACKER_STAT_COUNT] = {
+    "update_tracker_file_latency_seconds",
+    "update_tracker_parse_seconds",
+    "update_tracker_ingest_seconds",
+    "update_tracker_apply_seconds",
+    "update_tracker_frame_render_seconds",
+    "update_tracker_frame_flush_seconds",
+    "update_tracker_redraw_area_pixels",
+};
+
+/* Frame in progress */
+static uint64_t render_start_us;
+static uint64_t flush_start_us;
+static uint64_t frame_flush_us;
+
+static lv_timer_t *file_timer;      // rewrites UPDATE_TRACKER_STATS_PATH, NULL when only dumped on request
+#if HAVE_SIGUSR1
+static int dump_fds[2] = { -1, -1 }; // the SIGUSR1 handler wakes the main loop through this pipe
+#endif
+
+/**
+ * Measure the render and flush phases of every frame
+ */
+static void display_event_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    uint64_t now = tracker_stats_now_us();
+
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_RENDER_START: {
+            // The areas are joined by now, count each pixel once
+            uint64_t area = 0;
+            for (uint32_t i = 0; i < disp->inv_p; i++) {
+                if (!disp->inv_area_joined[i]) {
+                    area += (uint64_t)lv_area_get_size(&disp->inv_areas[i]);
+                }
+            }
+            tracker_stats_record(TRACKER_STAT_INV_AREA, area);
+            render_start_us = now;
+            frame_flush_us = 0;
+            break;
+        }
+        case LV_EVENT_RENDER_READY:
+            tracker_stats_record(TRACKER_STAT_RENDER, now - render_start_us - frame_flush_us);
+            tracker_stats_record(TRACKER_STAT_FLUSH, frame_flush_us);
+            break;
+        case LV_EVENT_FLUSH_START:
+#if LV_VERSION_CHECK(9, 2, 0)
+        case LV_EVENT_FLUSH_WAIT_START:
+#endif
+            flush_start_us = now;
+            break;
+        case LV_EVENT_FLUSH_FINISH:
+#if LV_VERSION_CHECK(9, 2, 0)
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+#endif
+            frame_flush_us += now - flush_start_us;
+            break;
+        default:
+            break;
+    }
+}
+
+#if HAVE_SIGUSR1
+static void dump_signal_handler(int signo)
+{
+    const char wake = 1;
+    int saved_errno = errno;
+    ssize_t ret;
+
+    (void)signo;
+    // A full pipe already holds a request
+    ret = write(dump_fds[1], &wake, 1);
+    (void)ret;
+    errno = saved_errno;
+}
+#endif
+
+#if UPDATE_TRACKER_USE_METRICS
+static void metrics_timer_cb(lv_timer_t *timer)
+{
+    static char metrics[METRICS_SIZE];
+    size_t len = tracker_stats_format_metrics(metrics, sizeof(metrics));
+
+    (void)timer;
+    if (len > 0) {
+        status_publish_write(UPDATE_TRACKER_METRICS_PATH, metrics, len);
+    }
+}
+#endif
+
+#if UPDATE_TRACKER_STATS_INTERVAL > 0
+static void file_timer_cb(lv_timer_t *timer)
+{
+    char report[REPORT_SIZE];
+    size_t len = tracker_stats_format(report, sizeof(report));
+
+    (void)timer;
+    if (len > 0) {
+        status_publish_write(UPDATE_TRACKER_STATS_PATH, report, len);
+    }
+}
+#endif
+
+void tracker_stats_init(lv_display_t *disp)
+{
+    if (disp != NULL) {
+        lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_ALL, NULL);
+    }
+#if HAVE_SIGUSR1
+    if (pipe(dump_fds) == 0) {
+        for (int i = 0; i < 2; i++) {
+            fcntl(dump_fds[i], F_SETFL, fcntl(dump_fds[i], F_GETFL) | O_NONBLOCK);
+            fcntl(dump_fds[i], F_SETFD, FD_CLOEXEC);
+        }
+        signal(SIGUSR1, dump_signal_handler);
+    } else {
+        dump_fds[0] = dump_fds[1] = -1;
+        printf("Warning: Cannot create the stats pipe, SIGUSR1 is ignored\n");
+    }
+#endif
+    // One timer per output at its own interval, none when nothing is written periodically
+#if UPDATE_TRACKER_STATS_INTERVAL > 0
+    file_timer = lv_timer_create(file_timer_cb, UPDATE_TRACKER_STATS_INTERVAL, NULL);
+#endif
+    printf("Update tracker: Timing stats enabled, written to %s\n", UPDATE_TRACKER_STATS_PATH);
+#if UPDATE_TRACKER_USE_METRICS
+    lv_timer_create(metrics_timer_cb, UPDATE_TRACKER_METRICS_INTERVAL, NULL);
+    printf("Update tracker: Metrics written to %s\n", UPDATE_TRACKER_METRICS_PATH);
+#endif
+}
+
+int tracker_stats_get_fd(void)
+{
+#if HAVE_SIGUSR1
+    return dump_fds[0];
+#else
+    return -1;
+#endif
+}
+
+void tracker_stats_process(void)
+{
+#if HAVE_SIGUSR1
+    char drain[16];
+    bool requested = false;
+
+    if (dump_fds[0] < 0) {
+        return;
+    }
+    while (read(dump_fds[0], drain, sizeof(drain)) > 0) {
+        requested = true;
+    }
+    if (requested) {
+        tracker_stats_dump();
+        // The file was just rewritten
+        if (file_timer != NULL) {
+            lv_timer_reset(file_timer);
+        }
+    }
+#endif
+}
+
+#endif /* UPDATE_TRACKER_USE_STATS */
+
+uint64_t tracker_stats_now_us(void)
+{
+#if IS_ZEPHYR
+    return k_ticks_to_us_floor64((uint64_t)k_uptime_ticks());
+#elif defined(_WIN32) || defined(_WIN64)
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+#endif
+}
+
+int64_t tracker_stats_wall_ns(void)
+{
+#if IS_ZEPHYR
+    return 0;  // no wall clock to compare file times against
+#elif defined(_WIN32) || defined(_WIN64)
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+#if UPDATE_TRACKER_USE_STATS
+
+void tracker_stats_record(tracker_stat_t stat, uint64_t value)
+{
+    tracker_hist_t *h = &hists[stat];
+    uint32_t bucket = 0;
+
+    while (value >> bucket && bucket < TRACKER_HIST_BUCKETS - 1) {
+        bucket++;
+    }
+    h->buckets[bucket]++;
+    h->count++;
+    h->sum += value;
+    if (value > h->max) {
+        h->max = value;
+    }
+}
+
+const tracker_hist_t *tracker_stats_get(tracker_stat_t stat)
+{
+    return &hists[stat];
+}
+
+/**
+ * Upper bound of the bucket holding the given fraction of the samples
+ */
+static uint64_t hist_percentile(const tracker_hist_t *h, uint32_t permille)
+{
+    uint64_t target = ((uint64_t)h->count * permille + 999) / 1000;
+    uint64_t seen = 0;
+
+    for (uint32_t i = 0; i < TRACKER_HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint64_t bound = i == 0 ? 0 : (1ULL << i) - 1;
+            return bound < h->max ? bound : h->max;
+        }
+    }
+    return h->max;
+}
+
+size_t tracker_stats_format(char *buf, size_t size)
+{
+    size_t pos = 0;
+    int n;
+
+#define REPORT(...) do { \
+        n = snprintf(buf + pos, size - pos, __VA_ARGS__); \
+        if (n < 0 || (size_t)n >= size - pos) return 0; \
+        pos += (size_t)n; \
+    } while (0)
+
+    REPORT("updates_applied %u\nwidget_updates %u\nwidget_updates_skipped %u\nupdates_coalesced %u\n"
+           "parse_errors %u\nsocket_dropped %u\nloop_wakeups %u\nidle_entries %u\nidle_ms %llu\nlog_lines_dropped %u\n",
+           (unsigned)tracker_counters.updates_applied, (unsigned)tracker_counters.widget_updates,
+           (unsigned)tracker_counters.widget_updates_skipped, (unsigned)tracker_counters.updates_coalesced,
+           (unsigned)tracker_counters.parse_errors, (unsigned)status_ingest_get_dropped(),
+           (unsigned)tracker_counters.loop_wakeups, (unsigned)tracker_counters.idle_entries,
+           (unsigned long long)tracker_counters.idle_ms, (unsigned)tracker_log_get_dropped());
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    {
+        // Peak and fragmentation of the LVGL heap; flat over a long update when the labels are static
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        REPORT("heap_total %u\nheap_used %u\nheap_max_used %u\nheap_free_biggest %u\nheap_frag_pct %u\n",
+               (unsigned)mon.total_size, (unsigned)(mon.total_size - mon.free_size), (unsigned)mon.max_used,
+               (unsigned)mon.free_biggest_size, (unsigned)mon.frag_pct);
+    }
+#endif
+    REPORT("%-16s %8s %10s %10s %10s %10s %10s\n", "stat", "count", "mean", "p50", "p90", "p99", "max");
+
+    for (uint32_t s = 0; s < TRACKER_STAT_COUNT; s++) {
+        const tracker_hist_t *h = &hists[s];
+        REPORT("%-16s %8u %10llu %10llu %10llu %10llu %10llu\n", stat_names[s], (unsigned)h->count,
+               (unsigned long long)(h->count ? h->sum / h->count : 0),
+               (unsigned long long)hist_percentile(h, 500), (unsigned long long)hist_percentile(h, 900),
+               (unsigned long long)hist_percentile(h, 990), (unsigned long long)h->max);
+    }
+
+    // Raw buckets, labelled by their exclusive upper bound
+    for (uint32_t s = 0; s < TRACKER_STAT_COUNT; s++) {
+        REPORT("%s:", stat_names[s]);
+        for (uint32_t i = 0; i < TRACKER_HIST_BUCKETS; i++) {
+            if (hists[s].buckets[i] != 0) {
+                REPORT(" <%llu=%u", 1ULL << i, (unsigned)hists[s].buckets[i]);
+            }
+        }
+        REPORT("\n");
+    }
+
+#undef REPORT
+
+    return pos;
+}
+
+/**
+ * Prometheus text exposition of the counters and histograms
+ */
+size_t tracker_stats_format_metrics(char *buf, size_t size)
+{
+    size_t pos = 0;
+    int n;
+
+#define METRIC(...) do { \
+        n = snprintf(buf + pos, size - pos, __VA_ARGS__); \
+        if (n < 0 || (size_t)n >= size - pos) return 0; \
+        pos += (size_t)n; \
+    } while (0)
+#define COUNTER(name, help, value) \
+    METRIC("# HELP " name " " help "\n# TYPE " name " counter\n" name " %llu\n", (unsigned long long)(value))
+#define GAUGE(name, help, value) \
+    METRIC("# HELP " name " " help "\n# TYPE " name " gauge\n" name " %llu\n", (unsigned long long)(value))
+
+    COUNTER("update_tracker_updates_received_total", "Status documents received from all sources.",
+            status_history_total());
+    COUNTER("update_tracker_updates_applied_total", "Status changes shown on screen.",
+            tracker_counters.updates_applied);
+    COUNTER("update_tracker_updates_coalesced_total", "Statuses replaced by a newer one before they were shown.",
+            tracker_counters.updates_coalesced);
+    COUNTER("update_tracker_parse_errors_total", "Status file documents given up on as malformed.",
+            tracker_counters.parse_errors);
+    COUNTER("update_tracker_socket_dropped_total", "Socket datagrams dropped as oversized or malformed.",
+            status_ingest_get_dropped());
+    COUNTER("update_tracker_widget_updates_total", "Label texts and bar values set.",
+            tracker_counters.widget_updates);
+    COUNTER("update_tracker_frames_total", "Frames rendered.", hists[TRACKER_STAT_RENDER].count);
+    COUNTER("update_tracker_redraw_pixels_total", "Pixels redrawn.", hists[TRACKER_STAT_INV_AREA].sum);
+    COUNTER("update_tracker_loop_wakeups_total", "Wakeups of the main loop.", tracker_counters.loop_wakeups);
+    COUNTER("update_tracker_idle_entries_total", "Times the display refresh was suspended.",
+            tracker_counters.idle_entries);
+    COUNTER("update_tracker_log_lines_dropped_total", "Log lines lost because the log ring was full.",
+            tracker_log_get_dropped());
+    METRIC("# HELP update_tracker_idle_seconds_total Time the display refresh was suspended.\n"
+           "# TYPE update_tracker_idle_seconds_total counter\n"
+           "update_tracker_idle_seconds_total %.3f\n", (double)tracker_counters.idle_ms / 1000.0);
+
+    // Summaries with the same percentiles as the text report, from the power of two buckets
+    for (uint32_t s = 0; s < TRACKER_STAT_COUNT; s++) {
+        const tracker_hist_t *h = &hists[s];
+        const char *name = metric_names[s];
+        double scale = s == TRACKER_STAT_INV_AREA ? 1.0 : 1e-6;
+
+        METRIC("# TYPE %s summary\n", name);
+        METRIC("%s{quantile=\"0.5\"} %.9g\n%s{quantile=\"0.9\"} %.9g\n%s{quantile=\"0.99\"} %.9g\n",
+               name, (double)hist_percentile(h, 500) * scale, name, (double)hist_percentile(h, 900) * scale,
+               name, (double)hist_percentile(h, 990) * scale);
+        METRIC("%s_sum %.9g\n%s_count %u\n", name, (double)h->sum * scale, name, (unsigned)h->count);
+        METRIC("# TYPE %s_max gauge\n%s_max %.9g\n", name, name, (double)h->max * scale);
+    }
+
+#if !IS_ZEPHYR && defined(CLOCK_PROCESS_CPUTIME_ID)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        METRIC("# HELP update_tracker_cpu_seconds_total CPU time used by the tracker.\n"
+               "# TYPE update_tracker_cpu_seconds_total counter\n"
+               "update_tracker_cpu_seconds_total %.6f\n", (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9);
+    }
+#endif
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    {
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        GAUGE("update_tracker_heap_bytes", "Size of the LVGL heap.", mon.total_size);
+        GAUGE("update_tracker_heap_used_bytes", "LVGL heap in use.", mon.total_size - mon.free_size);
+        GAUGE("update_tracker_heap_max_used_bytes", "High-water mark of the LVGL heap.", mon.max_used);
+        GAUGE("update_tracker_heap_free_biggest_bytes", "Largest free block of the LVGL heap.",
+              mon.free_biggest_size);
+        METRIC("# HELP update_tracker_heap_fragmentation_ratio Free LVGL heap outside its largest block.\n"
+               "# TYPE update_tracker_heap_fragmentation_ratio gauge\n"
+               "update_tracker_heap_fragmentation_ratio %.2f\n", (double)mon.frag_pct / 100.0);
+    }
+#endif
+
+#undef GAUGE
+#undef COUNTER
+#undef METRIC
+
+    return pos;
+}
+
+void tracker_stats_dump(void)
+{
+    char report[REPORT_SIZE];
+    size_t len = tracker_stats_format(report, sizeof(report));
+
+    if (len == 0) {
+        return;
+    }
+    fputs(report, stdout);
+    fflush(stdout);
+    status_publish_write(UPDATE_TRACKER_STATS_PATH, report, len);
+}
+
+#else /* UPDATE_TRACKER_USE_STATS */
+
+/* Stats are compiled out: only the counters above are kept */
+
+void tracker_stats_init(lv_display_t *disp)
+{
+    (void)disp;
+}
+
+int tracker_stats_get_fd(void)
+{
+    return -1;
+}
+
+void tracker_stats_process(void)
+{
+}
+
+void tracker_stats_record(tracker_stat_t stat, uint64_t value)
+{
+    (void)stat;
+    (void)value;
+}
+
+const tracker_hist_t *tracker_stats_get(tracker_stat_t stat)
+{
+    (void)stat;
+    return NULL;
+}
+
+size_t tracker_stats_format(char *buf, size_t size)
+{
+    (void)buf;
+    (void)size;
+    return 0;
+}
+
+size_t tracker_stats_format_metrics(char *buf, size_t size)
+{
+    (void)buf;
+    (void)size;
+    return 0;
+}
+
+void tracker_stats_dump(void)
+{
+}
+
+#endif /* UPDATE_TRACKER_USE_STATS */
@@ -0,0 +1,118 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+#ifndef TRACKER_STATS_H_
+#define TRACKER_STATS_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TRACKER_HIST_BUCKETS 32
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* Histogrammed measurements, all times in microseconds */
+typedef enum {
+    TRACKER_STAT_FILE_LATENCY,  // status file mtime to parse complete
+    TRACKER_STAT_PARSE,         // decoding one status document
+    TRACKER_STAT_INGEST,        // draining and decoding the ingest socket
+    TRACKER_STAT_APPLY,         // setting the label texts and the bar value
+    TRACKER_STAT_RENDER,        // rendering one frame, flushes excluded
+    TRACKER_STAT_FLUSH,         // flush callbacks and waiting for them, per frame
+    TRACKER_STAT_INV_AREA,      // invalidated pixels per frame
+    TRACKER_STAT_COUNT
+} tracker_stat_t;
+
+/* Bucket 0 counts zeros, bucket i values in [2^(i-1), 2^i), the last one the rest */
+typedef struct {
+    uint32_t buckets[TRACKER_HIST_BUCKETS];
+    uint32_t count;
+    uint64_t sum;
+    uint64_t max;
+} tracker_hist_t;
+
+/* Running totals of the update path, only touched from the LVGL thread */
+typedef struct {
+    uint32_t updates_applied;           // status changes shown on screen
+    uint32_t widget_updates;            // label texts and bar values set
+    uint32_t widget_updates_skipped;    // widgets left alone because their field did not change
+    uint32_t updates_coalesced;         // statuses replaced by a newer one before they were shown
+    uint32_t parse_errors;              // status file documents given up on as malformed
+    uint32_t loop_wakeups;              // returns of the main loop from its wait
+    uint32_t idle_entries;              // times the display refresh was suspended
+    uint64_t idle_ms;                   // time spent suspended, periods that ended
+} tracker_counters_t;
+
+/**********************
+ * GLOBAL VARIABLES
+ **********************/
+extern tracker_counters_t tracker_counters;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * Hook the display's render and flush events and set up the dumps.
+ * Does nothing unless built with UPDATE_TRACKER_USE_STATS.
+ */
+void tracker_stats_init(lv_display_t *disp);
+
+/**
+ * Get the descriptor that becomes readable when a dump is requested with SIGUSR1
+ * @return file descriptor or -1 without signals or stats
+ */
+int tracker_stats_get_fd(void);
+
+/**
+ * Serve a pending dump request, from the LVGL thread
+ */
+void tracker_stats_process(void);
+
+/**
+ * Monotonic time in microseconds, for timing a stage
+ */
+uint64_t tracker_stats_now_us(void);
+
+/**
+ * Wall clock time in nanoseconds, comparable to file modification times
+ */
+int64_t tracker_stats_wall_ns(void);
+
+void tracker_stats_record(tracker_stat_t stat, uint64_t value);
+const tracker_hist_t *tracker_stats_get(tracker_stat_t stat);
+
+/**
+ * Write a text report of the counters and histograms
+ * @return length of the report, 0 if it did not fit
+ */
+size_t tracker_stats_format(char *buf, size_t size);
+
+/**
+ * Write the counters and histograms in the Prometheus text format
+ * @return length of the metrics, 0 if they did not fit
+ */
+size_t tracker_stats_format_metrics(char *buf, size_t size);
+
+/**
+ * Print the report and rewrite the stats file
+ */
+void tracker_stats_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TRACKER_STATS_H_ */
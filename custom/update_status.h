@@ -0,0 +1,56 @@
+/*
+* Copyright 2024 NXP
+* NXP Proprietary. This software is owned or controlled by NXP and may only be used strictly in
+* accordance with the applicable license terms. By expressly accepting such terms or by downloading, installing,
+* activating and/or otherwise using the software, you are agreeing that you have read, and that you agree to
+* comply with and are bound by, such license terms.  If you do not agree to be bound by the applicable license
+* terms, then you may not retain, install, activate or otherwise use the software.
+*/
+
+#ifndef UPDATE_STATUS_H_
+#define UPDATE_STATUS_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UPDATE_STATUS_TEXT_LEN 64
+#define UPDATE_STATUS_ID_LEN   32
+
+/* Bits reported for the fields present in a status document */
+#define UPDATE_FIELD_PROGRESS       (1u << 0)
+#define UPDATE_FIELD_STATUS         (1u << 1)
+#define UPDATE_FIELD_STEP           (1u << 2)
+#define UPDATE_FIELD_ETA            (1u << 3)
+#define UPDATE_FIELD_BYTES_DONE     (1u << 4)
+#define UPDATE_FIELD_BYTES_TOTAL    (1u << 5)
+#define UPDATE_FIELD_COMPONENT      (1u << 6)
+#define UPDATE_FIELD_ERROR_CODE     (1u << 7)
+#define UPDATE_FIELD_SEQ            (1u << 8)
+#define UPDATE_FIELD_ID             (1u << 9)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* One snapshot of the update progress as published by the updater */
+typedef struct {
+    int progress;                           // 0..100
+    char status[UPDATE_STATUS_TEXT_LEN];
+    char step[UPDATE_STATUS_TEXT_LEN];
+    int32_t eta;                            // seconds remaining, -1 if unknown
+    int64_t bytes_done;
+    int64_t bytes_total;
+    char component[UPDATE_STATUS_TEXT_LEN];
+    int32_t error_code;                     // 0 if no error
+    int32_t seq;                            // producer's document number, 0 if not sent
+    char id[UPDATE_STATUS_ID_LEN];          // job the status belongs to, empty for the single update
+} update_status_t;
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* UPDATE_STATUS_H_ */
@@ -3,4 +3,6 @@
 DEPPATH += --dep-path $(PRJ_DIR)/generated/guider_fonts
 VPATH += :$(PRJ_DIR)/generated/guider_fonts
 
-CFLAGS += "-I$(PRJ_DIR)/generated/guider_fonts"
\ No newline at end of file
+CFLAGS += "-I$(PRJ_DIR)/generated/guider_fonts"
+
+-include $(PRJ_DIR)/custom/font_subset.mk
@@ -15,6 +15,99 @@
 #include "custom.h"
 
 
+/* Shared read-only styles: the objects point at them instead of each holding
+ * a heap allocated local style with the same properties */
+#define STYLE_MAIN  (LV_PART_MAIN|LV_STATE_DEFAULT)
+
+static const lv_style_const_prop_t screen_props[] = {
+    LV_STYLE_CONST_BG_OPA(255),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x19, 0x19, 0x19)),
+    LV_STYLE_CONST_BG_GRAD_DIR(LV_GRAD_DIR_NONE),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_screen, screen_props);
+
+static const lv_style_const_prop_t image_props[] = {
+    LV_STYLE_CONST_IMAGE_RECOLOR_OPA(0),
+    LV_STYLE_CONST_IMAGE_OPA(255),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_image, image_props);
+
+/* Common to the three labels */
+static const lv_style_const_prop_t label_props[] = {
+    LV_STYLE_CONST_BORDER_WIDTH(0),
+    LV_STYLE_CONST_RADIUS(0),
+    LV_STYLE_CONST_TEXT_OPA(255),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(0),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(0),
+    LV_STYLE_CONST_BG_OPA(0),
+    LV_STYLE_CONST_PAD_TOP(0),
+    LV_STYLE_CONST_PAD_RIGHT(0),
+    LV_STYLE_CONST_PAD_BOTTOM(0),
+    LV_STYLE_CONST_PAD_LEFT(0),
+    LV_STYLE_CONST_SHADOW_WIDTH(0),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_label, label_props);
+
+static const lv_style_const_prop_t progress_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xff, 0xff, 0xff)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserratMedium_32),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_RIGHT),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_progress, progress_props);
+
+static const lv_style_const_prop_t step_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xc4, 0x72, 0x38)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserratMedium_24),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_step, step_props);
+
+static const lv_style_const_prop_t status_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xff, 0xff, 0xff)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserratMedium_36),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_status, status_props);
+
+static const lv_style_const_prop_t bar_border_props[] = {
+    LV_STYLE_CONST_BORDER_WIDTH(2),
+    LV_STYLE_CONST_BORDER_OPA(255),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x83, 0xaa, 0xb8)),
+    LV_STYLE_CONST_BORDER_SIDE(LV_BORDER_SIDE_FULL),
+    LV_STYLE_CONST_RADIUS(15),
+    LV_STYLE_CONST_BG_OPA(0),
+    LV_STYLE_CONST_PAD_TOP(0),
+    LV_STYLE_CONST_PAD_BOTTOM(0),
+    LV_STYLE_CONST_PAD_LEFT(0),
+    LV_STYLE_CONST_PAD_RIGHT(0),
+    LV_STYLE_CONST_SHADOW_WIDTH(0),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_bar_border, bar_border_props);
+
+static const lv_style_const_prop_t bar_props[] = {
+    LV_STYLE_CONST_ANIM_DURATION(1000),
+    LV_STYLE_CONST_BG_OPA(0),
+    LV_STYLE_CONST_RADIUS(12),
+    LV_STYLE_CONST_SHADOW_WIDTH(0),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_bar, bar_props);
+
+static const lv_style_const_prop_t bar_indicator_props[] = {
+    LV_STYLE_CONST_BG_OPA(255),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x27, 0x55, 0x5b)),
+    LV_STYLE_CONST_BG_GRAD_DIR(LV_GRAD_DIR_NONE),
+    LV_STYLE_CONST_RADIUS(12),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(style_bar_indicator, bar_indicator_props);
 
 void setup_scr_screen(lv_ui *ui)
 {
@@ -24,9 +117,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_scrollbar_mode(ui->screen, LV_SCROLLBAR_MODE_OFF);
 
     //Write style for screen, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_bg_opa(ui->screen, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen, lv_color_hex(0x191919), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen, (lv_style_t *)&style_screen, STYLE_MAIN);
 
     //Write codes screen_Stratus
     ui->screen_Stratus = lv_image_create(ui->screen);
@@ -38,8 +129,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_image_set_rotation(ui->screen_Stratus, 0);
 
     //Write style for screen_Stratus, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_image_recolor_opa(ui->screen_Stratus, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_image_opa(ui->screen_Stratus, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_Stratus, (lv_style_t *)&style_image, STYLE_MAIN);
 
     //Write codes screen_progress
     ui->screen_progress = lv_label_create(ui->screen);
@@ -49,20 +139,8 @@ void setup_scr_screen(lv_ui *ui)
     lv_label_set_long_mode(ui->screen_progress, LV_LABEL_LONG_WRAP);
 
     //Write style for screen_progress, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_progress, lv_color_hex(0xffffff), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_progress, &lv_font_montserratMedium_32, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_progress, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_progress, LV_TEXT_ALIGN_RIGHT, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_progress, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_progress, (lv_style_t *)&style_label, STYLE_MAIN);
+    lv_obj_add_style(ui->screen_progress, (lv_style_t *)&style_progress, STYLE_MAIN);
 
     //Write codes screen_step
     ui->screen_step = lv_label_create(ui->screen);
@@ -72,20 +150,8 @@ void setup_scr_screen(lv_ui *ui)
     lv_label_set_long_mode(ui->screen_step, LV_LABEL_LONG_WRAP);
 
     //Write style for screen_step, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_step, lv_color_hex(0xc47238), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_step, &lv_font_montserratMedium_24, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_step, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_step, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_step, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_step, (lv_style_t *)&style_label, STYLE_MAIN);
+    lv_obj_add_style(ui->screen_step, (lv_style_t *)&style_step, STYLE_MAIN);
 
     //Write codes screen_status
     ui->screen_status = lv_label_create(ui->screen);
@@ -95,20 +161,8 @@ void setup_scr_screen(lv_ui *ui)
     lv_label_set_long_mode(ui->screen_status, LV_LABEL_LONG_WRAP);
 
     //Write style for screen_status, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_status, lv_color_hex(0xffffff), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_status, &lv_font_montserratMedium_36, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_status, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_status, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_status, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_status, (lv_style_t *)&style_label, STYLE_MAIN);
+    lv_obj_add_style(ui->screen_status, (lv_style_t *)&style_status, STYLE_MAIN);
 
     //Write codes screen_loading_bar_border
     ui->screen_loading_bar_border = lv_obj_create(ui->screen);
@@ -117,37 +171,21 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_scrollbar_mode(ui->screen_loading_bar_border, LV_SCROLLBAR_MODE_OFF);
 
     //Write style for screen_loading_bar_border, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_loading_bar_border, 2, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui->screen_loading_bar_border, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui->screen_loading_bar_border, lv_color_hex(0x83aab8), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_side(ui->screen_loading_bar_border, LV_BORDER_SIDE_FULL, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_loading_bar_border, 15, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_loading_bar_border, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_loading_bar_border, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_loading_bar_border, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_loading_bar_border, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_loading_bar_border, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_loading_bar_border, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_loading_bar_border, (lv_style_t *)&style_bar_border, STYLE_MAIN);
 
     //Write codes screen_loading_bar
     ui->screen_loading_bar = lv_bar_create(ui->screen);
     lv_obj_set_pos(ui->screen_loading_bar, 273, 445);
     lv_obj_set_size(ui->screen_loading_bar, 734, 54);
-    lv_obj_set_style_anim_duration(ui->screen_loading_bar, 1000, 0);
     lv_bar_set_mode(ui->screen_loading_bar, LV_BAR_MODE_NORMAL);
     lv_bar_set_range(ui->screen_loading_bar, 0, 100);
     lv_bar_set_value(ui->screen_loading_bar, 50, LV_ANIM_OFF);
 
     //Write style for screen_loading_bar, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_bg_opa(ui->screen_loading_bar, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_loading_bar, 12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_loading_bar, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_loading_bar, (lv_style_t *)&style_bar, STYLE_MAIN);
 
     //Write style for screen_loading_bar, Part: LV_PART_INDICATOR, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_bg_opa(ui->screen_loading_bar, 255, LV_PART_INDICATOR|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen_loading_bar, lv_color_hex(0x27555b), LV_PART_INDICATOR|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen_loading_bar, LV_GRAD_DIR_NONE, LV_PART_INDICATOR|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_loading_bar, 12, LV_PART_INDICATOR|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_loading_bar, (lv_style_t *)&style_bar_indicator, LV_PART_INDICATOR|LV_STATE_DEFAULT);
 
     //The custom code of screen.
 
@@ -14,6 +14,9 @@
 
 void ui_init_style(lv_style_t * style)
 {
+    /* Shared const styles live in flash and are never reset */
+    if (lv_style_is_const(style))
+        return;
     if (style->prop_cnt > 1)
         lv_style_reset(style);
     else
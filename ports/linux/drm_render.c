@@ -0,0 +1,266 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drm_render.h"
+
+#if LV_USE_LINUX_DRM
+
+/* The scanout buffers and the driver's flush callback are not exposed publicly */
+#include "src/display/lv_display_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PARTIAL_SCREEN_DIVIDER  10  // default partial buffer: a tenth of the screen
+#define MAX_SYNC_AREAS          16
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void counting_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void partial_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static drm_render_mode_t render_mode = DRM_RENDER_DIRECT;
+static drm_render_stats_t stats;
+static bool log_stats = false;
+static lv_display_flush_cb_t driver_flush_cb;
+
+/* Partial mode state */
+static lv_draw_buf_t scanout_bufs[2];   // copies of the driver's page flipped buffers
+static lv_draw_buf_t *scanout[2] = {&scanout_bufs[0], &scanout_bufs[1]};
+static int back_idx = 0;                // buffer not on screen, written this frame
+static bool frame_started = false;
+static lv_area_t prev_areas[MAX_SYNC_AREAS];    // areas of the frame on screen
+static uint32_t prev_area_cnt = 0;
+static bool prev_full = true;           // copy the whole front buffer instead
+static lv_area_t cur_areas[MAX_SYNC_AREAS];
+static uint32_t cur_area_cnt = 0;
+static bool cur_full = false;
+
+/**
+ * Parse the render mode from the environment
+ */
+static drm_render_mode_t mode_from_env(void)
+{
+    const char *mode = getenv("UPDATE_TRACKER_DRM_MODE");
+
+    if (mode == NULL || strcmp(mode, "direct") == 0) {
+        return DRM_RENDER_DIRECT;
+    }
+    if (strcmp(mode, "full") == 0) {
+        return DRM_RENDER_FULL;
+    }
+    if (strcmp(mode, "partial") == 0) {
+        return DRM_RENDER_PARTIAL;
+    }
+    printf("Warning: Unknown UPDATE_TRACKER_DRM_MODE '%s', using direct\n", mode);
+    return DRM_RENDER_DIRECT;
+}
+
+static uint32_t area_bytes(lv_display_t *disp, const lv_area_t *area)
+{
+    uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(disp));
+    return (uint32_t)lv_area_get_size(area) * px_size;
+}
+
+static void frame_done(void)
+{
+    stats.frames++;
+    if (log_stats) {
+        printf("DRM flush: frame %u, %u bytes copied\n", (unsigned)stats.frames, (unsigned)stats.last_frame_bytes);
+    }
+    stats.last_frame_bytes = 0;
+}
+
+/**
+ * Copy a rectangle between two buffers laid out like the screen
+ */
+static void copy_area(lv_draw_buf_t *dst, const uint8_t *src, uint32_t src_stride, const lv_area_t *area, uint32_t px_size)
+{
+    uint32_t w_bytes = (uint32_t)lv_area_get_width(area) * px_size;
+    uint8_t *d = dst->data + (size_t)area->y1 * dst->header.stride + (size_t)area->x1 * px_size;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(d, src, w_bytes);
+        d += dst->header.stride;
+        src += src_stride;
+    }
+}
+
+/**
+ * Bring the back buffer up to date with what changed in the frame on screen
+ */
+static void sync_back_buffer(lv_display_t *disp)
+{
+    lv_draw_buf_t *front = scanout[back_idx ^ 1];
+    lv_draw_buf_t *back = scanout[back_idx];
+    uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(disp));
+
+    if (prev_full) {
+        memcpy(back->data, front->data, (size_t)front->header.stride * front->header.h);
+        stats.last_frame_bytes += front->header.stride * front->header.h;
+        return;
+    }
+
+    for (uint32_t i = 0; i < prev_area_cnt; i++) {
+        const lv_area_t *a = &prev_areas[i];
+        const uint8_t *src = front->data + (size_t)a->y1 * front->header.stride + (size_t)a->x1 * px_size;
+        copy_area(back, src, front->header.stride, a, px_size);
+        stats.last_frame_bytes += area_bytes(disp, a);
+    }
+}
+
+/**
+ * Direct and full modes: the driver flushes, we only count
+ */
+static void counting_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    uint32_t bytes = area_bytes(disp, area);
+
+    stats.flushes++;
+    stats.bytes_copied += bytes;
+    stats.last_frame_bytes += bytes;
+    if (lv_display_flush_is_last(disp)) {
+        frame_done();
+    }
+
+    driver_flush_cb(disp, area, px_map);
+}
+
+/**
+ * Partial mode: copy the rendered area into the back scanout buffer and page
+ * flip once the last area of the frame arrived
+ */
+static void partial_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(disp));
+    uint32_t src_stride = lv_draw_buf_width_to_stride((uint32_t)lv_area_get_width(area), lv_display_get_color_format(disp));
+    uint32_t bytes = area_bytes(disp, area);
+
+    if (!frame_started) {
+        sync_back_buffer(disp);
+        frame_started = true;
+        cur_area_cnt = 0;
+        cur_full = false;
+    }
+
+    copy_area(scanout[back_idx], px_map, src_stride, area, px_size);
+    stats.flushes++;
+    stats.bytes_copied += bytes;
+    stats.last_frame_bytes += bytes;
+
+    // Remember the area, it has to be copied into the other buffer next frame
+    if (cur_area_cnt < MAX_SYNC_AREAS) {
+        cur_areas[cur_area_cnt++] = *area;
+    } else {
+        cur_full = true;
+    }
+
+    if (!lv_display_flush_is_last(disp)) {
+        lv_display_flush_ready(disp);
+        return;
+    }
+
+    memcpy(prev_areas, cur_areas, sizeof(lv_area_t) * cur_area_cnt);
+    prev_area_cnt = cur_area_cnt;
+    prev_full = cur_full;
+    frame_started = false;
+    frame_done();
+
+    // The driver page flips to whichever of its buffers it is given
+    lv_draw_buf_t *shown = scanout[back_idx];
+    back_idx ^= 1;
+    driver_flush_cb(disp, area, shown->data);
+}
+
+/**
+ * Switch to rendering into small buffers that are copied into the scanout buffers
+ * @return false if the buffers could not be set up
+ */
+static bool setup_partial(lv_display_t *disp)
+{
+    const char *lines_env = getenv("UPDATE_TRACKER_DRM_PARTIAL_LINES");
+    int32_t hor_res = lv_display_get_horizontal_resolution(disp);
+    int32_t ver_res = lv_display_get_vertical_resolution(disp);
+    int32_t lines = lines_env ? atoi(lines_env) : 0;
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+    uint32_t buf_size;
+    void *buf;
+
+    if (disp->buf_1 == NULL || disp->buf_2 == NULL) {
+        printf("Warning: DRM display is not double buffered, keeping direct mode\n");
+        return false;
+    }
+    if (lines <= 0 || lines > ver_res) {
+        lines = ver_res / PARTIAL_SCREEN_DIVIDER;
+    }
+
+    buf_size = lv_draw_buf_width_to_stride((uint32_t)hor_res, cf) * (uint32_t)lines;
+    buf = lv_malloc(buf_size + LV_DRAW_BUF_ALIGN);
+    if (buf == NULL) {
+        printf("Warning: No memory for a %u byte partial buffer, keeping direct mode\n", (unsigned)buf_size);
+        return false;
+    }
+
+    // Copied by value: lv_display_set_buffers() reinitialises the display's own descriptors
+    scanout_bufs[0] = *disp->buf_1;
+    scanout_bufs[1] = *disp->buf_2;
+    back_idx = 0;
+    prev_full = true;
+
+    lv_display_set_buffers(disp, lv_draw_buf_align(buf, cf), NULL, buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, partial_flush_cb);
+    printf("DRM render mode: partial, %d line buffer (%u bytes)\n", (int)lines, (unsigned)buf_size);
+    return true;
+}
+
+void drm_render_setup(lv_display_t *disp)
+{
+    const char *stats_env = getenv("UPDATE_TRACKER_DRM_STATS");
+
+    log_stats = stats_env != NULL && strcmp(stats_env, "0") != 0;
+    driver_flush_cb = disp->flush_cb;
+    render_mode = mode_from_env();
+
+    if (driver_flush_cb == NULL) {
+        return;
+    }
+
+    if (render_mode == DRM_RENDER_PARTIAL && setup_partial(disp)) {
+        return;
+    }
+    if (render_mode == DRM_RENDER_PARTIAL) {
+        render_mode = DRM_RENDER_DIRECT;
+    }
+
+    if (render_mode == DRM_RENDER_FULL) {
+        lv_display_set_render_mode(disp, LV_DISPLAY_RENDER_MODE_FULL);
+        printf("DRM render mode: full\n");
+    } else {
+        printf("DRM render mode: direct\n");
+    }
+    lv_display_set_flush_cb(disp, counting_flush_cb);
+}
+
+drm_render_mode_t drm_render_get_mode(void)
+{
+    return render_mode;
+}
+
+const drm_render_stats_t *drm_render_get_stats(void)
+{
+    return &stats;
+}
+
+#endif /* LV_USE_LINUX_DRM */
@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+#ifndef DRM_RENDER_H_
+#define DRM_RENDER_H_
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#if LV_USE_LINUX_DRM
+
+/*
+ * Render modes of the DRM display, selected at startup with
+ * UPDATE_TRACKER_DRM_MODE=direct|full|partial:
+ *  direct  - LVGL renders dirty areas straight into two scanout buffers
+ *            and page flips (driver default)
+ *  full    - every refresh re-renders the whole frame into two scanout
+ *            buffers and page flips
+ *  partial - LVGL renders into a small buffer sized to the dirty region; only
+ *            the dirty areas are copied into the back scanout buffer
+ * UPDATE_TRACKER_DRM_PARTIAL_LINES sets the height of the partial buffer and
+ * UPDATE_TRACKER_DRM_STATS=1 logs the bytes copied by every flush.
+ */
+typedef enum {
+    DRM_RENDER_DIRECT,
+    DRM_RENDER_FULL,
+    DRM_RENDER_PARTIAL,
+} drm_render_mode_t;
+
+typedef struct {
+    uint32_t frames;            // page flips requested
+    uint32_t flushes;           // flush callbacks, several per frame in partial mode
+    uint64_t bytes_copied;      // pixel bytes written to scanout buffers
+    uint32_t last_frame_bytes;
+} drm_render_stats_t;
+
+/**
+ * Apply the render mode selected in the environment.
+ * Must be called after lv_linux_drm_set_file() created the scanout buffers.
+ * @param disp DRM display
+ */
+void drm_render_setup(lv_display_t *disp);
+
+/**
+ * @return the active render mode
+ */
+drm_render_mode_t drm_render_get_mode(void);
+
+/**
+ * @return flush statistics since startup
+ */
+const drm_render_stats_t *drm_render_get_stats(void);
+
+#endif /* LV_USE_LINUX_DRM */
+
+#endif /* DRM_RENDER_H_ */
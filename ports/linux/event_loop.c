@@ -0,0 +1,145 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include "lvgl.h"
+#include "event_loop.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MAX_SOURCES     8
+#define TIMER_SOURCE    UINT32_MAX  // epoll tag of the deadline timer
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int fd;
+    event_loop_cb_t cb;
+    void *user_data;
+} event_source_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int epoll_fd = -1;
+static int timer_fd = -1;
+static event_source_t sources[MAX_SOURCES];
+static uint32_t source_cnt = 0;
+
+int event_loop_init(void)
+{
+    struct epoll_event ev;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        printf("Error: epoll_create1 failed (%s)\n", strerror(errno));
+        return -1;
+    }
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        printf("Error: timerfd_create failed (%s)\n", strerror(errno));
+        close(epoll_fd);
+        epoll_fd = -1;
+        return -1;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = TIMER_SOURCE;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) != 0) {
+        printf("Error: Cannot watch the deadline timer (%s)\n", strerror(errno));
+        close(timer_fd);
+        close(epoll_fd);
+        timer_fd = -1;
+        epoll_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int event_loop_add_fd(int fd, event_loop_cb_t cb, void *user_data)
+{
+    struct epoll_event ev;
+
+    if (epoll_fd < 0 || fd < 0 || source_cnt >= MAX_SOURCES) {
+        return -1;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = source_cnt;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        printf("Error: Cannot watch fd %d (%s)\n", fd, strerror(errno));
+        return -1;
+    }
+
+    sources[source_cnt].fd = fd;
+    sources[source_cnt].cb = cb;
+    sources[source_cnt].user_data = user_data;
+    source_cnt++;
+    return 0;
+}
+
+/**
+ * Arm the deadline timer, or disarm it when no LVGL timer is pending
+ */
+static void arm_timer(uint32_t idle_time)
+{
+    struct itimerspec its;
+
+    memset(&its, 0, sizeof(its));
+    if (idle_time != LV_NO_TIMER_READY) {
+        if (idle_time == 0) {
+            // A zero value would disarm the timer, fire as soon as possible instead
+            its.it_value.tv_nsec = 1;
+        } else {
+            its.it_value.tv_sec = idle_time / 1000;
+            its.it_value.tv_nsec = (long)(idle_time % 1000) * 1000000L;
+        }
+    }
+    timerfd_settime(timer_fd, 0, &its, NULL);
+}
+
+void event_loop_wait(uint32_t idle_time)
+{
+    struct epoll_event events[MAX_SOURCES + 1];
+    int count;
+
+    if (epoll_fd < 0) {
+        usleep(idle_time * 1000);
+        return;
+    }
+
+    arm_timer(idle_time);
+
+    do {
+        count = epoll_wait(epoll_fd, events, MAX_SOURCES + 1, -1);
+    } while (count < 0 && errno == EINTR);
+
+    for (int i = 0; i < count; i++) {
+        uint32_t tag = events[i].data.u32;
+
+        if (tag == TIMER_SOURCE) {
+            uint64_t expirations;
+            // Only the wakeup matters, lv_timer_handler() runs next
+            if (read(timer_fd, &expirations, sizeof(expirations)) < 0) {
+                continue;
+            }
+        } else if (tag < source_cnt && sources[tag].cb != NULL) {
+            sources[tag].cb(sources[tag].fd, sources[tag].user_data);
+        }
+    }
+}
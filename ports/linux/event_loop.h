@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+#ifndef EVENT_LOOP_H_
+#define EVENT_LOOP_H_
+
+#include <stdint.h>
+
+/* Called on the main thread when fd becomes readable */
+typedef void (*event_loop_cb_t)(int fd, void *user_data);
+
+/**
+ * Create the epoll set and the timer that tracks the next LVGL deadline.
+ * @return 0 on success, -1 on error
+ */
+int event_loop_init(void);
+
+/**
+ * Wake the loop whenever fd becomes readable.
+ * @param fd descriptor to watch; it is dropped automatically when closed
+ * @param cb handler, may be NULL if waking up is all that is needed
+ * @param user_data passed to cb
+ * @return 0 on success, -1 on error
+ */
+int event_loop_add_fd(int fd, event_loop_cb_t cb, void *user_data);
+
+/**
+ * Sleep until the next LVGL timer is due or a watched descriptor is readable,
+ * then run the handlers of the ready descriptors.
+ * @param idle_time time to the next timer in milliseconds (LV_NO_TIMER_READY if none)
+ */
+void event_loop_wait(uint32_t idle_time);
+
+#endif /* EVENT_LOOP_H_ */
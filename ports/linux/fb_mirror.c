@@ -0,0 +1,550 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "fb_mirror.h"
+
+/* The render mode and the active buffer of the display are not exposed publicly */
+#include "src/display/lv_display_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_ADDR        "127.0.0.1"
+#define MAX_PENDING_AREAS   16
+#define RUN_MIN             3           // shorter repeats are cheaper as literals
+#define TOKEN_MAX           0x8000      // pixels per token
+#define IDLE_CHECK_S        1           // how often an idle connection is checked for a hangup
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void mirror_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static fb_mirror_stats_t stats;
+static lv_display_flush_cb_t driver_flush_cb;
+static lv_color_format_t color_format;
+static int32_t hor_res;
+static int32_t ver_res;
+static uint16_t *shadow;                // the screen as last flushed, in RGB565
+static uint16_t *row_tokens;            // one encoded row
+
+/* Areas changed since the last frame the viewer got */
+static lv_area_t pending[MAX_PENDING_AREAS];
+static uint32_t pending_cnt = 0;
+static bool hello_pending = false;
+
+/* Encoded messages, written by the LVGL thread, sent by the mirror thread */
+static uint8_t *queue;
+static uint32_t queue_size;             // a power of two
+static atomic_uint queue_head;
+static atomic_uint queue_tail;
+static sem_t queue_wake;
+
+static int listen_fd = -1;
+static int wake_fds[2] = { -1, -1 };   // a viewer connected, the LVGL thread sends it a keyframe
+static atomic_bool client_active;
+static atomic_bool need_keyframe;
+
+/**
+ * Convert one row of display pixels to RGB565
+ */
+static void row_to_rgb565(uint16_t *dst, const uint8_t *src, int32_t w)
+{
+    switch (color_format) {
+        case LV_COLOR_FORMAT_RGB565:
+            memcpy(dst, src, (size_t)w * 2);
+            break;
+        case LV_COLOR_FORMAT_RGB888:
+            for (int32_t x = 0; x < w; x++, src += 3) {
+                dst[x] = (uint16_t)(((src[2] & 0xf8) << 8) | ((src[1] & 0xfc) << 3) | (src[0] >> 3));
+            }
+            break;
+        default:
+            // XRGB8888 and ARGB8888: B, G, R, A in memory
+            for (int32_t x = 0; x < w; x++, src += 4) {
+                dst[x] = (uint16_t)(((src[2] & 0xf8) << 8) | ((src[1] & 0xfc) << 3) | (src[0] >> 3));
+            }
+            break;
+    }
+}
+
+static bool area_contains(const lv_area_t *outer, const lv_area_t *inner)
+{
+    return inner->x1 >= outer->x1 && inner->y1 >= outer->y1 && inner->x2 <= outer->x2 && inner->y2 <= outer->y2;
+}
+
+/**
+ * Remember an area for the next frame, merging them once there are too many
+ */
+static void add_pending(const lv_area_t *area)
+{
+    for (uint32_t i = 0; i < pending_cnt; i++) {
+        if (area_contains(&pending[i], area)) {
+            return;
+        }
+        if (area_contains(area, &pending[i])) {
+            pending[i] = *area;
+            return;
+        }
+    }
+    if (pending_cnt < MAX_PENDING_AREAS) {
+        pending[pending_cnt++] = *area;
+        return;
+    }
+
+    // Out of slots: send the bounding box of everything
+    lv_area_t *box = &pending[0];
+    for (uint32_t i = 1; i < pending_cnt; i++) {
+        box->x1 = LV_MIN(box->x1, pending[i].x1);
+        box->y1 = LV_MIN(box->y1, pending[i].y1);
+        box->x2 = LV_MAX(box->x2, pending[i].x2);
+        box->y2 = LV_MAX(box->y2, pending[i].y2);
+    }
+    box->x1 = LV_MIN(box->x1, area->x1);
+    box->y1 = LV_MIN(box->y1, area->y1);
+    box->x2 = LV_MAX(box->x2, area->x2);
+    box->y2 = LV_MAX(box->y2, area->y2);
+    pending_cnt = 1;
+}
+
+/**
+ * Copy a flushed area into the shadow frame
+ */
+static void capture_area(lv_display_t *disp, const lv_area_t *area, const uint8_t *px_map)
+{
+    uint32_t px_size = lv_color_format_get_size(color_format);
+    uint32_t stride;
+    lv_area_t clipped;
+
+    clipped.x1 = LV_MAX(area->x1, 0);
+    clipped.y1 = LV_MAX(area->y1, 0);
+    clipped.x2 = LV_MIN(area->x2, hor_res - 1);
+    clipped.y2 = LV_MIN(area->y2, ver_res - 1);
+    if (clipped.x1 > clipped.x2 || clipped.y1 > clipped.y2) {
+        return;
+    }
+
+    // A partial buffer holds the area alone, the other modes give the whole frame
+    if (disp->render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL) {
+        stride = lv_draw_buf_width_to_stride((uint32_t)lv_area_get_width(area), color_format);
+        px_map += (size_t)(clipped.y1 - area->y1) * stride + (size_t)(clipped.x1 - area->x1) * px_size;
+    } else {
+        stride = disp->buf_act->header.stride;
+        px_map += (size_t)clipped.y1 * stride + (size_t)clipped.x1 * px_size;
+    }
+
+    for (int32_t y = clipped.y1; y <= clipped.y2; y++) {
+        row_to_rgb565(&shadow[(size_t)y * hor_res + clipped.x1], px_map, lv_area_get_width(&clipped));
+        px_map += stride;
+    }
+    add_pending(&clipped);
+}
+
+/**
+ * Run-length encode a row of pixels
+ * @return the tokens and pixels written, in 16-bit units
+ */
+static uint32_t encode_row(const uint16_t *px, int32_t n, uint16_t *out)
+{
+    uint32_t o = 0;
+    int32_t i = 0;
+
+    while (i < n) {
+        int32_t run = 1;
+        while (i + run < n && px[i + run] == px[i] && run < TOKEN_MAX) {
+            run++;
+        }
+        if (run >= RUN_MIN) {
+            out[o++] = (uint16_t)(0x8000 | (run - 1));
+            out[o++] = px[i];
+            i += run;
+            continue;
+        }
+
+        // Literals up to the next run worth encoding
+        int32_t start = i;
+        while (i < n && i - start < TOKEN_MAX) {
+            if (i + 2 < n && px[i] == px[i + 1] && px[i] == px[i + 2]) {
+                break;
+            }
+            i++;
+        }
+        out[o++] = (uint16_t)(i - start - 1);
+        memcpy(&out[o], &px[start], (size_t)(i - start) * 2);
+        o += (uint32_t)(i - start);
+    }
+    return o;
+}
+
+static void queue_write_at(uint32_t pos, const void *data, uint32_t len)
+{
+    uint32_t off = pos & (queue_size - 1);
+    uint32_t first = LV_MIN(len, queue_size - off);
+
+    memcpy(&queue[off], data, first);
+    memcpy(queue, (const uint8_t *)data + first, len - first);
+}
+
+static void queue_read_at(uint32_t pos, void *data, uint32_t len)
+{
+    uint32_t off = pos & (queue_size - 1);
+    uint32_t first = LV_MIN(len, queue_size - off);
+
+    memcpy(data, &queue[off], first);
+    memcpy((uint8_t *)data + first, queue, len - first);
+}
+
+/**
+ * Append to the frame being written, not yet visible to the mirror thread
+ * @return false if the queue has no room
+ */
+static bool queue_put(uint32_t *pos, uint32_t tail, const void *data, uint32_t len)
+{
+    if (queue_size - (*pos - tail) < len) {
+        return false;
+    }
+    queue_write_at(*pos, data, len);
+    *pos += len;
+    return true;
+}
+
+static bool put_rect(uint32_t *pos, uint32_t tail, const lv_area_t *area)
+{
+    fb_mirror_msg_t msg = {
+        .type = FB_MIRROR_MSG_RECT,
+        .x = (uint16_t)area->x1, .y = (uint16_t)area->y1,
+        .w = (uint16_t)lv_area_get_width(area), .h = (uint16_t)lv_area_get_height(area),
+    };
+    uint32_t msg_pos = *pos;
+
+    if (!queue_put(pos, tail, &msg, sizeof(msg))) {
+        return false;
+    }
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        uint32_t units = encode_row(&shadow[(size_t)y * hor_res + area->x1], msg.w, row_tokens);
+        if (!queue_put(pos, tail, row_tokens, units * 2)) {
+            return false;
+        }
+    }
+
+    // The length is only known now, the header is still ours to rewrite
+    msg.len = *pos - msg_pos - (uint32_t)sizeof(msg);
+    queue_write_at(msg_pos, &msg, sizeof(msg));
+    stats.pixels += (uint64_t)msg.w * msg.h;
+    return true;
+}
+
+/**
+ * Encode the areas changed since the last frame and hand them to the mirror thread.
+ * Without room the areas stay pending and go out with the next frame.
+ */
+static void queue_frame(void)
+{
+    uint32_t head = atomic_load_explicit(&queue_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue_tail, memory_order_acquire);
+    uint32_t pos = head;
+
+    if (!atomic_load_explicit(&client_active, memory_order_acquire)) {
+        pending_cnt = 0;
+        return;
+    }
+    if (atomic_exchange_explicit(&need_keyframe, false, memory_order_acq_rel)) {
+        lv_area_t screen = { 0, 0, hor_res - 1, ver_res - 1 };
+        hello_pending = true;
+        pending_cnt = 0;
+        add_pending(&screen);
+    }
+    if (pending_cnt == 0) {
+        return;
+    }
+
+    if (hello_pending) {
+        fb_mirror_msg_t hello = {
+            .type = FB_MIRROR_MSG_HELLO, .x = FB_MIRROR_FORMAT_RGB565_RLE,
+            .w = (uint16_t)hor_res, .h = (uint16_t)ver_res,
+        };
+        if (!queue_put(&pos, tail, &hello, sizeof(hello))) {
+            stats.frames_merged++;
+            return;
+        }
+    }
+    for (uint32_t i = 0; i < pending_cnt; i++) {
+        if (!put_rect(&pos, tail, &pending[i])) {
+            stats.frames_merged++;
+            return;
+        }
+    }
+    fb_mirror_msg_t end = { .type = FB_MIRROR_MSG_FRAME_END };
+    if (!queue_put(&pos, tail, &end, sizeof(end))) {
+        stats.frames_merged++;
+        return;
+    }
+
+    atomic_store_explicit(&queue_head, pos, memory_order_release);
+    sem_post(&queue_wake);
+    stats.frames++;
+    stats.bytes += pos - head;
+    pending_cnt = 0;
+    hello_pending = false;
+}
+
+static void mirror_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    // Before the driver gets the buffer back and may reuse it
+    capture_area(disp, area, px_map);
+    if (lv_display_flush_is_last(disp)) {
+        queue_frame();
+    }
+
+    driver_flush_cb(disp, area, px_map);
+}
+
+/**
+ * Send a message straight from the queue
+ * @return false once the viewer is gone
+ */
+static bool send_queued(int fd, uint32_t pos, uint32_t len)
+{
+    while (len > 0) {
+        uint32_t off = pos & (queue_size - 1);
+        uint32_t chunk = LV_MIN(len, queue_size - off);
+        ssize_t sent = send(fd, &queue[off], chunk, MSG_NOSIGNAL);
+
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        pos += (uint32_t)sent;
+        len -= (uint32_t)sent;
+    }
+    return true;
+}
+
+/**
+ * @return false if the viewer closed the connection
+ */
+static bool client_alive(int fd)
+{
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    char discard[64];
+
+    if (poll(&pfd, 1, 0) <= 0) {
+        return true;
+    }
+    // Viewers send nothing, readable means closed
+    return recv(fd, discard, sizeof(discard), MSG_DONTWAIT) > 0;
+}
+
+/**
+ * Stream the queued frames to one viewer until it disconnects
+ */
+static void serve_client(int fd)
+{
+    uint32_t tail = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+    bool synced = false;
+
+    for (;;) {
+        fb_mirror_msg_t msg;
+        uint32_t total;
+
+        if (atomic_load_explicit(&queue_head, memory_order_acquire) == tail) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += IDLE_CHECK_S;
+            if (sem_timedwait(&queue_wake, &ts) != 0 && !client_alive(fd)) {
+                return;
+            }
+            continue;
+        }
+
+        queue_read_at(tail, &msg, sizeof(msg));
+        total = (uint32_t)sizeof(msg) + msg.len;
+
+        // Frames queued for an earlier viewer are skipped up to this one's keyframe
+        if (synced || msg.type == FB_MIRROR_MSG_HELLO) {
+            synced = true;
+            if (!send_queued(fd, tail, total)) {
+                return;
+            }
+        }
+        tail += total;
+        atomic_store_explicit(&queue_tail, tail, memory_order_release);
+    }
+}
+
+/**
+ * Accept one viewer at a time, the others wait in the listen backlog
+ */
+static void *mirror_main(void *arg)
+{
+    LV_UNUSED(arg);
+
+    for (;;) {
+        const char wake = 1;
+        int one = 1;
+        int fd = accept(listen_fd, NULL, NULL);
+
+        if (fd < 0) {
+            if (errno != EINTR) {
+                usleep(100000);
+            }
+            continue;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        stats.clients++;
+
+        atomic_store_explicit(&need_keyframe, true, memory_order_release);
+        atomic_store_explicit(&client_active, true, memory_order_release);
+        // Without the wakeup the keyframe goes out with the next frame
+        if (write(wake_fds[1], &wake, 1) < 0 && errno != EAGAIN) {
+            printf("Warning: Cannot wake the LVGL thread for the mirror (%s)\n", strerror(errno));
+        }
+        serve_client(fd);
+        atomic_store_explicit(&client_active, false, memory_order_release);
+        close(fd);
+    }
+    return NULL;
+}
+
+static bool open_listener(const char *addr, int port)
+{
+    struct sockaddr_in sin = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port) };
+    int one = 1;
+
+    if (inet_pton(AF_INET, addr, &sin.sin_addr) != 1) {
+        printf("Warning: Invalid UPDATE_TRACKER_MIRROR_ADDR '%s', display not mirrored\n", addr);
+        return false;
+    }
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        printf("Warning: Cannot create the mirror socket (%s)\n", strerror(errno));
+        return false;
+    }
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(listen_fd, (struct sockaddr *)&sin, sizeof(sin)) != 0 || listen(listen_fd, 1) != 0) {
+        printf("Warning: Cannot listen on %s:%d for the mirror (%s)\n", addr, port, strerror(errno));
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+void fb_mirror_setup(lv_display_t *disp)
+{
+    const char *port_env = getenv("UPDATE_TRACKER_MIRROR_PORT");
+    const char *addr = getenv("UPDATE_TRACKER_MIRROR_ADDR");
+    pthread_t thread;
+    size_t frame_bytes;
+
+    if (port_env == NULL || disp->flush_cb == NULL) {
+        return;
+    }
+    if (addr == NULL) {
+        addr = DEFAULT_ADDR;
+    }
+
+    color_format = lv_display_get_color_format(disp);
+    if (color_format != LV_COLOR_FORMAT_RGB565 && color_format != LV_COLOR_FORMAT_RGB888 &&
+        color_format != LV_COLOR_FORMAT_XRGB8888 && color_format != LV_COLOR_FORMAT_ARGB8888) {
+        printf("Warning: Cannot mirror a display of color format %d\n", (int)color_format);
+        return;
+    }
+    hor_res = lv_display_get_horizontal_resolution(disp);
+    ver_res = lv_display_get_vertical_resolution(disp);
+
+    // Room for a raw keyframe, so a new viewer can always be served
+    frame_bytes = (size_t)hor_res * (size_t)ver_res * 2;
+    for (queue_size = 4096; queue_size < frame_bytes + frame_bytes / 8; queue_size <<= 1) {
+    }
+
+    shadow = calloc((size_t)hor_res * (size_t)ver_res, sizeof(uint16_t));
+    row_tokens = malloc(((size_t)hor_res * 2 + 2) * sizeof(uint16_t));
+    queue = malloc(queue_size);
+    if (shadow == NULL || row_tokens == NULL || queue == NULL) {
+        printf("Warning: No memory to mirror the display\n");
+        goto fail;
+    }
+    if (pipe(wake_fds) != 0) {
+        printf("Warning: Cannot create the mirror pipe (%s)\n", strerror(errno));
+        wake_fds[0] = wake_fds[1] = -1;
+        goto fail;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(wake_fds[i], F_SETFL, fcntl(wake_fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(wake_fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    if (!open_listener(addr, atoi(port_env))) {
+        goto fail;
+    }
+    if (sem_init(&queue_wake, 0, 0) != 0 || pthread_create(&thread, NULL, mirror_main, NULL) != 0) {
+        printf("Warning: Cannot start the mirror thread\n");
+        close(listen_fd);
+        goto fail;
+    }
+    pthread_detach(thread);
+
+    driver_flush_cb = disp->flush_cb;
+    lv_display_set_flush_cb(disp, mirror_flush_cb);
+    printf("Update tracker: Mirroring the display on %s:%s (%u KiB queue)\n", addr, port_env,
+           (unsigned)(queue_size / 1024));
+    return;
+
+fail:
+    if (wake_fds[0] >= 0) {
+        close(wake_fds[0]);
+        close(wake_fds[1]);
+        wake_fds[0] = wake_fds[1] = -1;
+    }
+    free(shadow);
+    free(row_tokens);
+    free(queue);
+    shadow = NULL;
+    row_tokens = NULL;
+    queue = NULL;
+}
+
+int fb_mirror_get_fd(void)
+{
+    return wake_fds[0];
+}
+
+void fb_mirror_process(void)
+{
+    char drain[16];
+
+    while (read(wake_fds[0], drain, sizeof(drain)) > 0) {
+    }
+    // A static screen flushes nothing, the new viewer gets the shadow frame now
+    queue_frame();
+}
+
+const fb_mirror_stats_t *fb_mirror_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+#ifndef FB_MIRROR_H_
+#define FB_MIRROR_H_
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/*
+ * Remote mirror of the display, enabled at startup with
+ * UPDATE_TRACKER_MIRROR_PORT=<tcp port>. It listens on 127.0.0.1 unless
+ * UPDATE_TRACKER_MIRROR_ADDR gives another address; reach it with an SSH
+ * tunnel rather than exposing the screen on the network.
+ *
+ * Only the areas LVGL flushes are sent, as RGB565 run-length encoded
+ * rectangles, so the bandwidth follows the changed area. The flush only
+ * copies the area into a shadow frame; the frame is encoded into a bounded
+ * queue that a thread sends. A slow viewer never stalls the display: the
+ * changed areas are merged until the queue has room again.
+ *
+ * Stream, all fields little-endian, every message starts with fb_mirror_msg_t:
+ *  HELLO      x = pixel format (1: RGB565 RLE), w x h = screen size, once per connection
+ *  RECT       len bytes of RLE rows of the w x h rectangle at x, y
+ *  FRAME_END  the rectangles since the last one form a frame
+ * An RLE row is a series of 16-bit tokens: bit 15 set, the next pixel is
+ * repeated (token & 0x7fff) + 1 times; clear, token + 1 literal pixels follow.
+ * tools/fb_mirror_view.py is a viewer.
+ */
+
+#define FB_MIRROR_FORMAT_RGB565_RLE 1
+
+typedef enum {
+    FB_MIRROR_MSG_HELLO = 1,
+    FB_MIRROR_MSG_RECT = 2,
+    FB_MIRROR_MSG_FRAME_END = 3,
+} fb_mirror_msg_type_t;
+
+typedef struct {
+    uint16_t type;
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint16_t reserved;
+    uint32_t len;               // payload bytes after the header
+} fb_mirror_msg_t;
+
+typedef struct {
+    uint32_t frames;            // frames queued for the viewer
+    uint32_t frames_merged;     // frames merged into a later one while the queue was full
+    uint64_t pixels;            // pixels of the rectangles queued
+    uint64_t bytes;             // encoded bytes queued
+    uint32_t clients;           // viewers that connected
+} fb_mirror_stats_t;
+
+/**
+ * Mirror the display when UPDATE_TRACKER_MIRROR_PORT is set.
+ * Must be called once the flush callback of the display is final.
+ * @param disp display to mirror
+ */
+void fb_mirror_setup(lv_display_t *disp);
+
+/**
+ * @return descriptor readable when a viewer connected, -1 if the display is not mirrored
+ */
+int fb_mirror_get_fd(void);
+
+/**
+ * Send the current screen to a viewer that just connected.
+ * Call on the LVGL thread when fb_mirror_get_fd() is readable.
+ */
+void fb_mirror_process(void);
+
+/**
+ * @return mirror statistics since startup
+ */
+const fb_mirror_stats_t *fb_mirror_get_stats(void);
+
+#endif /* FB_MIRROR_H_ */
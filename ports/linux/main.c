@@ -11,39 +11,176 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include "lvgl.h"
+#if LV_USE_LINUX_DRM && LV_USE_EVDEV
+#include <fcntl.h>
+#include <linux/input.h>
+#endif
 #include "update_tracker.h"
 #include "events_init.h"
 #include "custom.h"
+#include "idle_mode.h"
+#include "tracker_stats.h"
+#include "startup.h"
+#include "event_loop.h"
+#include "drm_render.h"
+#include "fb_mirror.h"
+#include "wayland_render.h"
+#if LV_USE_VIDEO
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include "video_pipeline.h"
+#endif
+
+#define MAX_EVENT_FDS 4
 
 static void hal_init(void);
+static void event_loop_setup(void);
+static void idle_setup(void);
 
 lv_ui guider_ui;
 
+static const char *backlight_path;  // dimmed while the screen is static
+static char backlight_level[16];    // brightness restored on wakeup
+static char backlight_dim[16];
+
+#if LV_USE_LINUX_DRM && LV_USE_EVDEV
+static lv_indev_t *touch_indev;
+#endif
+
 #if LV_USE_VIDEO
-pthread_t video_thread;
-void *videoPlayThread()
+#if UPDATE_TRACKER_GG_VIDEO
+static pthread_t video_thread;
+static int video_event_fd = -1;
+static long video_period_ns;
+static atomic_bool video_frame_drawn;           // video_play() invalidated an area since the last wakeup
+static _Thread_local bool on_video_thread = false;
+
+/**
+ * An area invalidated from the video thread is a frame video_play() produced
+ */
+static void video_invalidate_cb(lv_event_t *e)
 {
-    for (;;)
-    {
+    LV_UNUSED(e);
+    if (on_video_thread) {
+        atomic_store_explicit(&video_frame_drawn, true, memory_order_relaxed);
+    }
+}
+
+/**
+ * GUI Guider's video hook, played on its own thread at the frame period
+ */
+static void *video_play_thread(void *arg)
+{
+    struct timespec next;
+    struct timespec now;
+
+    LV_UNUSED(arg);
+    on_video_thread = true;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (;;) {
         video_play(&guider_ui);
+        /* Wake the main loop only for a new frame, an idle screen stays asleep */
+        if (atomic_exchange_explicit(&video_frame_drawn, false, memory_order_relaxed) && video_event_fd >= 0) {
+            eventfd_write(video_event_fd, 1);
+        }
+
+        next.tv_nsec += video_period_ns;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        /* Behind schedule: start the next period now rather than catching up in a burst */
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > next.tv_sec || (now.tv_sec == next.tv_sec && now.tv_nsec > next.tv_nsec)) {
+            next = now;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+static void video_event_cb(int fd, void *user_data)
+{
+    eventfd_t frames;
+    LV_UNUSED(user_data);
+    eventfd_read(fd, &frames);
+}
+
+/**
+ * Run the generated video_play() on its thread, paced at fps
+ */
+static void video_play_start(uint32_t fps)
+{
+    video_period_ns = 1000000000L / (long)(fps ? fps : 30);
+    video_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (video_event_fd >= 0 && event_loop_add_fd(video_event_fd, video_event_cb, NULL) != 0) {
+        close(video_event_fd);
+        video_event_fd = -1;
+    }
+    lv_display_add_event_cb(lv_display_get_default(), video_invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    if (pthread_create(&video_thread, NULL, video_play_thread, NULL) != 0) {
+        printf("Warning: Cannot start the video thread\n");
+    }
+}
+#endif /* UPDATE_TRACKER_GG_VIDEO */
+
+/**
+ * Play the stream named by UPDATE_TRACKER_VIDEO over the active screen.
+ * Decoding runs on its own threads, one per core by default, and frames
+ * are shown by an LVGL timer. Without it, a GUI Guider project with a video
+ * (generated/gg_video.c) runs video_play() on its thread at
+ * UPDATE_TRACKER_VIDEO_FPS; the two never run together since both use
+ * OpenH264.
+ */
+static void video_setup(void)
+{
+    const char *path = getenv("UPDATE_TRACKER_VIDEO");
+    const char *fps = getenv("UPDATE_TRACKER_VIDEO_FPS");
+    const char *threads = getenv("UPDATE_TRACKER_VIDEO_THREADS");
+    lv_obj_t *img;
+
+    if (path == NULL) {
+#if UPDATE_TRACKER_GG_VIDEO
+        video_play_start(fps ? (uint32_t)atoi(fps) : 30);
+#endif
+        return;
+    }
+
+    img = lv_image_create(lv_screen_active());
+    if (video_pipeline_start(path, img, fps ? (uint32_t)atoi(fps) : 30,
+                             threads ? atoi(threads) : (int)sysconf(_SC_NPROCESSORS_ONLN)) == NULL) {
+        printf("Warning: video %s not played\n", path);
+        lv_obj_delete(img);
     }
 }
 #endif
 
 int main(void)
 {
+    startup_mark("main");
+
     /* Initialize LVGL */
     lv_init();
 
     /* Initialize the HAL (display, input devices) for LVGL */
     hal_init();
+    startup_mark("hal_init");
+
+    /* Put the logo on screen before the rest of the UI is built */
+    startup_show_splash();
 
     /* Create the update tracker app */
     setup_ui(&guider_ui);
+    startup_release_splash();
+    startup_mark("setup_ui");
     events_init(&guider_ui);
     custom_init(&guider_ui);
+    event_loop_setup();
+    idle_setup();
 #if LV_USE_VIDEO
-     pthread_create(&video_thread, NULL, videoPlayThread, NULL);
+    video_setup();
 #endif
 
     uint32_t idle_time;
@@ -53,7 +190,8 @@ int main(void)
     while (1) {
         idle_time = lv_wayland_timer_handler();
 
-        usleep(idle_time * 1000);
+        event_loop_wait(idle_time);
+        tracker_counters.loop_wakeups++;
 
         /* Run until the last window closes */
         if (!lv_wayland_window_is_open(NULL)) {
@@ -64,13 +202,125 @@ int main(void)
     while(1) {
         /* Return the time to the next timer execution */
         idle_time = lv_timer_handler();
-	usleep(idle_time * 1000);
+        event_loop_wait(idle_time);
+        tracker_counters.loop_wakeups++;
     }
 #endif
 
     return 0;
 }
 
+static void custom_event_cb(int fd, void *user_data)
+{
+    LV_UNUSED(fd);
+    LV_UNUSED(user_data);
+    custom_process_events();
+}
+
+static void mirror_event_cb(int fd, void *user_data)
+{
+    LV_UNUSED(fd);
+    LV_UNUSED(user_data);
+    fb_mirror_process();
+}
+
+#if LV_USE_LINUX_DRM && LV_USE_EVDEV
+static void evdev_event_cb(int fd, void *user_data)
+{
+    struct input_event events[16];
+
+    /* Only a wakeup: lv_evdev reads the same events from its own descriptor */
+    while (read(fd, events, sizeof(events)) > 0) {
+    }
+    idle_mode_wake();
+    lv_indev_read((lv_indev_t *)user_data);
+}
+#endif
+
+/**
+ * Register every event source with the main loop, so it only wakes up for
+ * real input, status changes or the next LVGL timer
+ */
+static void event_loop_setup(void)
+{
+    int fds[MAX_EVENT_FDS];
+    int count;
+    int i;
+
+    if (event_loop_init() != 0) {
+        printf("Warning: epoll unavailable, falling back to timed sleeps\n");
+        return;
+    }
+
+    count = custom_get_event_fds(fds, MAX_EVENT_FDS);
+    for (i = 0; i < count; i++) {
+        if (event_loop_add_fd(fds[i], custom_event_cb, NULL) != 0) {
+            break;
+        }
+    }
+    /* Only then may the tracker stop polling its status file */
+    if (i == count) {
+        custom_attach_event_loop();
+    }
+    if (fb_mirror_get_fd() >= 0) {
+        event_loop_add_fd(fb_mirror_get_fd(), mirror_event_cb, NULL);
+    }
+
+#if LV_USE_WAYLAND
+    /* Events are read and dispatched by lv_wayland_timer_handler() right after the wakeup */
+    event_loop_add_fd(lv_wayland_get_fd(), NULL, NULL);
+#elif LV_USE_LINUX_DRM && LV_USE_EVDEV
+    if (touch_indev != NULL) {
+        /* lv_evdev does not expose its descriptor: a second one on the device
+         * receives a copy of every event and wakes the loop */
+        int evdev_fd = open(LV_EVDEV_DEVICE, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (evdev_fd >= 0 && event_loop_add_fd(evdev_fd, evdev_event_cb, touch_indev) == 0) {
+            /* Read on demand instead of polling the device every period */
+            lv_indev_set_mode(touch_indev, LV_INDEV_MODE_EVENT);
+        } else if (evdev_fd >= 0) {
+            close(evdev_fd);
+        }
+    }
+#endif
+}
+
+static void write_backlight(const char *level)
+{
+    FILE *f = fopen(backlight_path, "w");
+    if (f != NULL) {
+        fputs(level, f);
+        fclose(f);
+    }
+}
+
+static void idle_power_cb(bool idle)
+{
+    write_backlight(idle ? backlight_dim : backlight_level);
+}
+
+/**
+ * Dim the backlight named by UPDATE_TRACKER_IDLE_BACKLIGHT (a sysfs brightness
+ * file) to UPDATE_TRACKER_IDLE_BRIGHTNESS, a quarter by default, while the
+ * screen is static. The panel keeps showing the last frame, no page flips
+ * are made meanwhile.
+ */
+static void idle_setup(void)
+{
+    const char *dim = getenv("UPDATE_TRACKER_IDLE_BRIGHTNESS");
+    FILE *f;
+
+    backlight_path = getenv("UPDATE_TRACKER_IDLE_BACKLIGHT");
+    if (backlight_path == NULL || (f = fopen(backlight_path, "r")) == NULL) {
+        return;
+    }
+    if (fgets(backlight_level, sizeof(backlight_level), f) != NULL) {
+        snprintf(backlight_dim, sizeof(backlight_dim), "%d", dim ? atoi(dim) : (atoi(backlight_level) + 3) / 4);
+        idle_mode_set_power_cb(idle_power_cb);
+        printf("Update tracker: Dimming %s to %s while idle\n", backlight_path, backlight_dim);
+    }
+    fclose(f);
+}
+
 /**
  * Initialize the Hardware Abstraction Layer (HAL) for the LVGL graphics library
  */
@@ -86,11 +336,13 @@ static void hal_init(void)
     lv_group_t * g = lv_group_create();
     lv_group_set_default(g);
     lv_indev_set_group(lv_wayland_get_pointeraxis(disp), g);
+    wayland_render_setup(disp);
 #elif LV_USE_LINUX_DRM
     disp = lv_linux_drm_create();
 
 #if LV_USE_EVDEV
     lv_indev_t * touch = lv_evdev_create(LV_INDEV_TYPE_POINTER, LV_EVDEV_DEVICE);
+    touch_indev = touch;
     if(touch != NULL) {
         lv_indev_set_display(touch, disp);
 
@@ -105,7 +357,11 @@ static void hal_init(void)
 #endif
 
     lv_linux_drm_set_file(disp, LV_LINUX_DRM_CARD, -1);
+    drm_render_setup(disp);
 #else
 #error Unsupported Backend
 #endif
+
+    /* Wraps whichever flush callback the backend ended up with */
+    fb_mirror_setup(disp);
 }
@@ -7,6 +7,7 @@
 
 #include "h264_dec.h"
 #include <cstdio>
+#include <cstring>
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,49 +15,113 @@ extern "C" {
 
 #if LV_USE_VIDEO != 0
 
-static ISVCDecoder *s_pDecoder;
+struct h264_decoder {
+    ISVCDecoder *pDecoder;
+};
 
+static h264_decoder_t *s_pDefault;
 
-int OpenH264_Init(void)
+
+h264_decoder_t *h264_decoder_create(int threads)
 {
-    int result               = WelsCreateDecoder(&s_pDecoder);
-    SDecodingParam sDecParam = {0};
+    h264_decoder_t *dec = new h264_decoder_t;
+    SDecodingParam sDecParam;
 
-    if (result == 0)
+    if (WelsCreateDecoder(&dec->pDecoder) != 0)
     {
-        sDecParam.uiTargetDqLayer             = 255;
-        sDecParam.eEcActiveIdc                = ERROR_CON_SLICE_COPY;
-        sDecParam.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
-        result                                = s_pDecoder->Initialize(&sDecParam);
+        delete dec;
+        return NULL;
     }
 
     int iLevelSetting = (int) WELS_LOG_WARNING;
-    s_pDecoder->SetOption (DECODER_OPTION_TRACE_LEVEL, &iLevelSetting);
-    return (result == 0) ? 0 : -1;
+    dec->pDecoder->SetOption (DECODER_OPTION_TRACE_LEVEL, &iLevelSetting);
+
+    /* The thread count is only read by Initialize() */
+    if (threads > 1)
+    {
+        int iThreadCount = threads > H264_DECODER_MAX_THREADS ? H264_DECODER_MAX_THREADS : threads;
+        dec->pDecoder->SetOption (DECODER_OPTION_NUM_OF_THREADS, &iThreadCount);
+    }
+
+    memset(&sDecParam, 0, sizeof(sDecParam));
+    sDecParam.uiTargetDqLayer             = 255;
+    sDecParam.eEcActiveIdc                = ERROR_CON_SLICE_COPY;
+    sDecParam.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
+    if (dec->pDecoder->Initialize(&sDecParam) != 0)
+    {
+        WelsDestroyDecoder(dec->pDecoder);
+        delete dec;
+        return NULL;
+    }
+    return dec;
+}
+
+int h264_decoder_decode(h264_decoder_t *dec, const unsigned char *pSrc, int iSrcLen,
+                        unsigned char **ppDst, SBufferInfo *pDstInfo)
+{
+    return dec->pDecoder->DecodeFrameNoDelay(pSrc, iSrcLen, ppDst, pDstInfo);
+}
+
+bool h264_decoder_flush(h264_decoder_t *dec, unsigned char **ppDst, SBufferInfo *pDstInfo)
+{
+    int remaining = 0;
+
+    dec->pDecoder->GetOption(DECODER_OPTION_NUM_OF_FRAMES_REMAINING_IN_BUFFER, &remaining);
+    if (remaining <= 0)
+    {
+        return false;
+    }
+    dec->pDecoder->FlushFrame(ppDst, pDstInfo);
+    return true;
+}
+
+void h264_decoder_reset(h264_decoder_t *dec)
+{
+    unsigned char *pDst[3];
+    SBufferInfo sDstInfo;
+
+    do
+    {
+        memset(&sDstInfo, 0, sizeof(sDstInfo));
+    } while (h264_decoder_flush(dec, pDst, &sDstInfo));
+}
+
+void h264_decoder_destroy(h264_decoder_t *dec)
+{
+    if (dec == NULL)
+    {
+        return;
+    }
+    dec->pDecoder->Uninitialize();
+    WelsDestroyDecoder(dec->pDecoder);
+    delete dec;
+}
+
+int OpenH264_Init(void)
+{
+    s_pDefault = h264_decoder_create(1);
+    return (s_pDefault != NULL) ? 0 : -1;
 }
 
 int OpenH264_Decode(const unsigned char* pSrc, const int iSrcLen, unsigned char** ppDst, SBufferInfo* pDstInfo) {
-    int rst;
-    rst = s_pDecoder->DecodeFrameNoDelay(pSrc, iSrcLen, ppDst, pDstInfo);
-    //DecodeFrame2
-    return rst;
+    return h264_decoder_decode(s_pDefault, pSrc, iSrcLen, ppDst, pDstInfo);
 }
 
 void OpenH264_GetOption(void* pOption)
 {
-	s_pDecoder->GetOption(DECODER_OPTION_NUM_OF_FRAMES_REMAINING_IN_BUFFER, pOption);
+	s_pDefault->pDecoder->GetOption(DECODER_OPTION_NUM_OF_FRAMES_REMAINING_IN_BUFFER, pOption);
 }
 
 void OpenH264_FlashFrame(unsigned char** ppDst, SBufferInfo* pDstInfo)
 {
-	s_pDecoder->FlushFrame(ppDst, pDstInfo);
+	s_pDefault->pDecoder->FlushFrame(ppDst, pDstInfo);
 }
 
 
 void OpenH264_Uninit(void)
 {
-    s_pDecoder->Uninitialize();
-    WelsDestroyDecoder(s_pDecoder);
+    h264_decoder_destroy(s_pDefault);
+    s_pDefault = NULL;
 }
 
 #endif /* LV_USE_VIDEO */
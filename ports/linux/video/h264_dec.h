@@ -17,9 +17,45 @@ extern "C" {
 
 #include "wels/codec_api.h"
 #include "wels/codec_def.h"
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
+#define H264_DECODER_MAX_THREADS    4   /* one per core of the quad-core targets */
+
+/** Independent decoder instance, one per stream */
+typedef struct h264_decoder h264_decoder_t;
+
+/**
+ * Create a decoder
+ * @param threads   decoding threads, 0 or 1 decodes on the calling thread
+ * @return the decoder, NULL on failure
+ */
+h264_decoder_t *h264_decoder_create(int threads);
+
+/**
+ * Decode one NAL unit
+ * @param ppDst     the planes of a picture, valid until the next call on the decoder
+ * @param pDstInfo  iBufferStatus is 1 when a picture is out
+ * @return OpenH264 state, 0 when the unit decoded cleanly
+ */
+int h264_decoder_decode(h264_decoder_t *dec, const unsigned char *pSrc, int iSrcLen,
+                        unsigned char **ppDst, SBufferInfo *pDstInfo);
+
+/**
+ * Get the next picture still held by the decoder, at the end of a stream
+ * @return false when none is left
+ */
+bool h264_decoder_flush(h264_decoder_t *dec, unsigned char **ppDst, SBufferInfo *pDstInfo);
+
+/**
+ * Drop the pictures still held and restart at the next IDR picture
+ */
+void h264_decoder_reset(h264_decoder_t *dec);
+
+void h264_decoder_destroy(h264_decoder_t *dec);
+
+/* Single decoder API, kept on a default instance */
 int OpenH264_Init(void);
 int OpenH264_Decode(const unsigned char* pSrc, const int iSrcLen, unsigned char** ppDst, SBufferInfo* pDstInfo);
 void OpenH264_GetOption(void* pOption);
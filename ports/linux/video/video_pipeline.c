@@ -0,0 +1,455 @@
+/*
+ * Copyright 2025 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "video_pipeline.h"
+
+#if LV_USE_VIDEO
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "h264_dec.h"
+
+/* With the 2D engine the frames stay YUV and are colour converted while drawn */
+#if defined(UPDATE_TRACKER_DRAW_G2D) && UPDATE_TRACKER_DRAW_G2D
+#define VIDEO_OUT_YUV       1
+#define VIDEO_OUT_CF        LV_COLOR_FORMAT_I420
+#elif LV_COLOR_DEPTH == 16
+#define VIDEO_OUT_YUV       0
+#define VIDEO_OUT_CF        LV_COLOR_FORMAT_RGB565
+#else
+#define VIDEO_OUT_YUV       0
+#define VIDEO_OUT_CF        LV_COLOR_FORMAT_XRGB8888
+#endif
+
+typedef enum {
+    FRAME_FREE,
+    FRAME_DECODING,
+    FRAME_QUEUED,
+    FRAME_SHOWN,
+} frame_state_t;
+
+typedef struct {
+    lv_draw_buf_t buf;
+    void *data;
+    int64_t pts_us;
+    frame_state_t state;
+} video_frame_t;
+
+struct video_pipeline {
+    /* Shared between the decoder and the LVGL thread, under the lock */
+    pthread_mutex_t lock;
+    pthread_cond_t frame_freed;
+    video_frame_t pool[VIDEO_POOL_FRAMES];
+    int queue[VIDEO_QUEUE_LEN];
+    uint32_t queue_head;
+    uint32_t queue_cnt;
+    atomic_bool running;            // also read by the decoder without the lock, between NALs
+    video_pipeline_stats_t stats;
+
+    /* Decoder thread only */
+    pthread_t thread;
+    h264_decoder_t *decoder;
+    const uint8_t *stream;
+    size_t stream_len;
+    int32_t frame_w;
+    int32_t frame_h;
+    int64_t next_pts_us;
+
+    /* LVGL thread only */
+    lv_obj_t *img;
+    lv_timer_t *present_timer;
+    int shown_idx;
+    int64_t clock_base_us;  /* monotonic time of pts 0, -1 before the first frame */
+    uint32_t frame_us;
+};
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * Find the next NAL unit of an Annex-B stream, start code included
+ * @return length of the unit, 0 at the end of the stream
+ */
+static size_t next_nal(const video_pipeline_t *vp, size_t pos, const uint8_t **nal)
+{
+    const uint8_t *stream = vp->stream;
+    size_t len = vp->stream_len;
+    size_t start = pos;
+    size_t i;
+
+    // Skip to the start code of this unit
+    while (start + 3 <= len && !(stream[start] == 0 && stream[start + 1] == 0 && stream[start + 2] == 1)) {
+        start++;
+    }
+    if (start + 3 > len) {
+        return 0;
+    }
+    // A 4 byte start code keeps its leading zero with the unit
+    if (start > pos && stream[start - 1] == 0) {
+        start--;
+    }
+
+    for (i = start + 4; i + 3 <= len; i++) {
+        if (stream[i] == 0 && stream[i + 1] == 0 && (stream[i + 2] == 1 || (stream[i + 2] == 0 && i + 3 < len && stream[i + 3] == 1))) {
+            break;
+        }
+    }
+    if (i + 3 > len) {
+        i = len;
+    }
+
+    *nal = stream + start;
+    return i - start;
+}
+
+static uint8_t clamp_u8(int v)
+{
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+/**
+ * Store a decoded picture into a pool frame: a plane copy in YUV mode,
+ * otherwise a BT.601 conversion straight into the display format
+ */
+static void store_picture(const video_pipeline_t *vp, video_frame_t *f, unsigned char *planes[3], const SBufferInfo *info)
+{
+    const int y_stride = info->UsrData.sSystemBuffer.iStride[0];
+    const int uv_stride = info->UsrData.sSystemBuffer.iStride[1];
+    const int32_t w = vp->frame_w;
+    const int32_t h = vp->frame_h;
+    uint8_t *dst = f->buf.data;
+
+#if VIDEO_OUT_YUV
+    for (int32_t y = 0; y < h; y++) {
+        memcpy(dst + (size_t)y * w, planes[0] + (size_t)y * y_stride, (size_t)w);
+    }
+    dst += (size_t)w * h;
+    for (int p = 1; p < 3; p++) {
+        for (int32_t y = 0; y < h / 2; y++) {
+            memcpy(dst + (size_t)y * (w / 2), planes[p] + (size_t)y * uv_stride, (size_t)w / 2);
+        }
+        dst += (size_t)(w / 2) * (h / 2);
+    }
+#else
+    for (int32_t y = 0; y < h; y++) {
+        const uint8_t *py = planes[0] + (size_t)y * y_stride;
+        const uint8_t *pu = planes[1] + (size_t)(y / 2) * uv_stride;
+        const uint8_t *pv = planes[2] + (size_t)(y / 2) * uv_stride;
+        uint8_t *row = dst + (size_t)y * f->buf.header.stride;
+
+        for (int32_t x = 0; x < w; x++) {
+            int c = 298 * (py[x] - 16);
+            int d = pu[x / 2] - 128;
+            int e = pv[x / 2] - 128;
+            uint8_t r = clamp_u8((c + 409 * e + 128) >> 8);
+            uint8_t g = clamp_u8((c - 100 * d - 208 * e + 128) >> 8);
+            uint8_t b = clamp_u8((c + 516 * d + 128) >> 8);
+#if LV_COLOR_DEPTH == 16
+            uint16_t px = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+            memcpy(row + x * 2, &px, 2);
+#else
+            row[x * 4 + 0] = b;
+            row[x * 4 + 1] = g;
+            row[x * 4 + 2] = r;
+            row[x * 4 + 3] = 0xFF;
+#endif
+        }
+    }
+#endif
+}
+
+/**
+ * Allocate the pool once the stream size is known
+ * @return false without memory
+ */
+static bool pool_alloc(video_pipeline_t *vp, int32_t w, int32_t h)
+{
+    uint32_t stride = lv_draw_buf_width_to_stride((uint32_t)w, VIDEO_OUT_CF);
+    uint32_t size = VIDEO_OUT_YUV ? (uint32_t)(w * h * 3 / 2) : stride * (uint32_t)h;
+
+    for (int i = 0; i < VIDEO_POOL_FRAMES; i++) {
+        video_frame_t *f = &vp->pool[i];
+
+        // lv_malloc() is not thread safe, the pixels come from the C heap
+        f->data = malloc(size + LV_DRAW_BUF_ALIGN);
+        if (f->data == NULL) {
+            return false;
+        }
+        lv_draw_buf_init(&f->buf, (uint32_t)w, (uint32_t)h, VIDEO_OUT_CF,
+                         VIDEO_OUT_YUV ? (uint32_t)w : stride,
+                         lv_draw_buf_align(f->data, VIDEO_OUT_CF), size);
+    }
+    vp->frame_w = w;
+    vp->frame_h = h;
+    return true;
+}
+
+/**
+ * Take a free frame, waiting while the queue is full
+ * @return -1 when stopping
+ */
+static int acquire_frame(video_pipeline_t *vp)
+{
+    int idx = -1;
+
+    pthread_mutex_lock(&vp->lock);
+    while (vp->running) {
+        for (int i = 0; i < VIDEO_POOL_FRAMES; i++) {
+            if (vp->pool[i].state == FRAME_FREE && vp->queue_cnt < VIDEO_QUEUE_LEN) {
+                idx = i;
+                break;
+            }
+        }
+        if (idx >= 0) {
+            vp->pool[idx].state = FRAME_DECODING;
+            break;
+        }
+        // No spinning: the LVGL thread signals when it releases a frame
+        pthread_cond_wait(&vp->frame_freed, &vp->lock);
+    }
+    pthread_mutex_unlock(&vp->lock);
+    return idx;
+}
+
+static void queue_frame(video_pipeline_t *vp, int idx)
+{
+    pthread_mutex_lock(&vp->lock);
+    vp->pool[idx].state = FRAME_QUEUED;
+    vp->queue[(vp->queue_head + vp->queue_cnt) % VIDEO_QUEUE_LEN] = idx;
+    vp->queue_cnt++;
+    vp->stats.decoded++;
+    pthread_mutex_unlock(&vp->lock);
+}
+
+/**
+ * Hand a decoded picture to the LVGL thread
+ * @return false when stopping
+ */
+static bool output_picture(video_pipeline_t *vp, unsigned char *planes[3], const SBufferInfo *info)
+{
+    int idx;
+
+    if (info->iBufferStatus != 1) {
+        return true;
+    }
+    if (vp->frame_w == 0 &&
+        !pool_alloc(vp, info->UsrData.sSystemBuffer.iWidth, info->UsrData.sSystemBuffer.iHeight)) {
+        printf("Error: No memory for the video frame pool\n");
+        return false;
+    }
+
+    idx = acquire_frame(vp);
+    if (idx < 0) {
+        return false;
+    }
+    store_picture(vp, &vp->pool[idx], planes, info);
+    vp->pool[idx].pts_us = vp->next_pts_us;
+    vp->next_pts_us += vp->frame_us;
+    queue_frame(vp, idx);
+    return true;
+}
+
+static void *decoder_main(void *arg)
+{
+    video_pipeline_t *vp = arg;
+
+    while (vp->running) {
+        unsigned char *planes[3] = {NULL, NULL, NULL};
+        SBufferInfo info;
+        size_t pos = 0;
+        const uint8_t *nal;
+        size_t len;
+
+        while (vp->running && (len = next_nal(vp, pos, &nal)) > 0) {
+            memset(&info, 0, sizeof(info));
+            h264_decoder_decode(vp->decoder, nal, (int)len, planes, &info);
+            if (!output_picture(vp, planes, &info)) {
+                return NULL;
+            }
+            pos = (size_t)(nal - vp->stream) + len;
+        }
+
+        // End of stream: collect the pictures still held for reordering, then loop
+        memset(&info, 0, sizeof(info));
+        while (vp->running && h264_decoder_flush(vp->decoder, planes, &info)) {
+            if (!output_picture(vp, planes, &info)) {
+                return NULL;
+            }
+            memset(&info, 0, sizeof(info));
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Release a frame back to the pool and wake the decoder, called under the lock
+ */
+static void release_frame(video_pipeline_t *vp, int idx)
+{
+    vp->pool[idx].state = FRAME_FREE;
+    pthread_cond_signal(&vp->frame_freed);
+}
+
+/**
+ * LVGL thread: show the frame that is due now, drop the ones already overtaken
+ */
+static void present_timer_cb(lv_timer_t *timer)
+{
+    video_pipeline_t *vp = lv_timer_get_user_data(timer);
+    int show = -1;
+    int64_t now = now_us();
+
+    pthread_mutex_lock(&vp->lock);
+    if (vp->queue_cnt > 0 && vp->clock_base_us < 0) {
+        vp->clock_base_us = now - vp->pool[vp->queue[vp->queue_head]].pts_us;
+    }
+    while (vp->queue_cnt > 0) {
+        int front = vp->queue[vp->queue_head];
+        int next = vp->queue[(vp->queue_head + 1) % VIDEO_QUEUE_LEN];
+
+        if (vp->clock_base_us + vp->pool[front].pts_us > now) {
+            break;
+        }
+        // A newer frame is due as well: this one is late, skip it
+        if (vp->queue_cnt > 1 && vp->clock_base_us + vp->pool[next].pts_us <= now) {
+            release_frame(vp, front);
+            vp->stats.dropped_late++;
+        } else {
+            show = front;
+        }
+        vp->queue_head = (vp->queue_head + 1) % VIDEO_QUEUE_LEN;
+        vp->queue_cnt--;
+        if (show >= 0) {
+            break;
+        }
+    }
+    if (show >= 0) {
+        if (vp->shown_idx >= 0) {
+            release_frame(vp, vp->shown_idx);
+        }
+        vp->pool[show].state = FRAME_SHOWN;
+        vp->shown_idx = show;
+        vp->stats.shown++;
+    }
+    pthread_mutex_unlock(&vp->lock);
+
+    if (show >= 0) {
+        // The buffer is reused for other pictures, never trust a cached decode of it
+        lv_image_cache_drop(&vp->pool[show].buf);
+        lv_image_set_src(vp->img, &vp->pool[show].buf);
+    }
+}
+
+static bool stream_open(video_pipeline_t *vp, const char *path)
+{
+    struct stat st;
+    void *map;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    vp->stream = map;
+    vp->stream_len = (size_t)st.st_size;
+    return true;
+}
+
+video_pipeline_t *video_pipeline_start(const char *path, lv_obj_t *img, uint32_t fps, int threads)
+{
+    video_pipeline_t *vp = calloc(1, sizeof(*vp));
+
+    if (vp == NULL) {
+        return NULL;
+    }
+    if (!stream_open(vp, path)) {
+        printf("Error: Cannot open video %s\n", path);
+        free(vp);
+        return NULL;
+    }
+    vp->decoder = h264_decoder_create(threads);
+    if (vp->decoder == NULL) {
+        munmap((void *)vp->stream, vp->stream_len);
+        free(vp);
+        return NULL;
+    }
+
+    pthread_mutex_init(&vp->lock, NULL);
+    pthread_cond_init(&vp->frame_freed, NULL);
+    vp->img = img;
+    vp->shown_idx = -1;
+    vp->clock_base_us = -1;
+    vp->frame_us = 1000000 / (fps ? fps : 30);
+    vp->running = true;
+    if (pthread_create(&vp->thread, NULL, decoder_main, vp) != 0) {
+        vp->running = false;
+        video_pipeline_stop(vp);
+        return NULL;
+    }
+
+    // Checked twice per frame so a frame is never shown more than half a period late
+    vp->present_timer = lv_timer_create(present_timer_cb, vp->frame_us / 2000 ? vp->frame_us / 2000 : 1, vp);
+    return vp;
+}
+
+void video_pipeline_stop(video_pipeline_t *vp)
+{
+    if (vp == NULL) {
+        return;
+    }
+
+    if (vp->running) {
+        pthread_mutex_lock(&vp->lock);
+        vp->running = false;
+        pthread_cond_broadcast(&vp->frame_freed);
+        pthread_mutex_unlock(&vp->lock);
+        pthread_join(vp->thread, NULL);
+    }
+
+    if (vp->present_timer != NULL) {
+        lv_timer_delete(vp->present_timer);
+    }
+    h264_decoder_destroy(vp->decoder);
+    munmap((void *)vp->stream, vp->stream_len);
+
+    lv_image_set_src(vp->img, NULL);
+    for (int i = 0; i < VIDEO_POOL_FRAMES; i++) {
+        lv_image_cache_drop(&vp->pool[i].buf);
+        free(vp->pool[i].data);
+    }
+    pthread_cond_destroy(&vp->frame_freed);
+    pthread_mutex_destroy(&vp->lock);
+    free(vp);
+}
+
+const video_pipeline_stats_t *video_pipeline_get_stats(const video_pipeline_t *vp)
+{
+    return &vp->stats;
+}
+
+#endif /* LV_USE_VIDEO */
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2025 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __VIDEO_PIPELINE_H__
+#define __VIDEO_PIPELINE_H__
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+#include "lvgl.h"
+#if LV_USE_VIDEO
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define VIDEO_POOL_FRAMES   4   /* decoded frames in flight: queued, shown and being decoded */
+#define VIDEO_QUEUE_LEN     (VIDEO_POOL_FRAMES - 2)
+
+typedef struct {
+    uint32_t decoded;       /* frames out of the decoder */
+    uint32_t shown;         /* frames handed to the image */
+    uint32_t dropped_late;  /* frames skipped because a newer one was already due */
+} video_pipeline_stats_t;
+
+/** One stream played into one image, with its own decoder and frame pool */
+typedef struct video_pipeline video_pipeline_t;
+
+/**
+ * Start decoding an H.264 Annex-B elementary stream into an image widget.
+ * A decoder thread fills a bounded queue of pooled frames. The LVGL thread
+ * shows the frame due at each tick and drops the ones that are already late.
+ * @param path      elementary stream, replayed in a loop
+ * @param img       image widget showing the video
+ * @param fps       frame rate of the stream
+ * @param threads   OpenH264 decoding threads, 0 or 1 for single threaded
+ * @return the pipeline, NULL if the file or the decoder can't be opened
+ */
+video_pipeline_t *video_pipeline_start(const char *path, lv_obj_t *img, uint32_t fps, int threads);
+
+/**
+ * Stop the decoder thread and free the frame pool
+ */
+void video_pipeline_stop(video_pipeline_t *vp);
+
+const video_pipeline_stats_t *video_pipeline_get_stats(const video_pipeline_t *vp);
+
+#endif /* LV_USE_VIDEO */
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+#endif /* __VIDEO_PIPELINE_H__ */
@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "wayland_render.h"
+#include "tracker_log.h"
+
+#if LV_USE_WAYLAND
+
+/* The driver's flush callback is not exposed publicly */
+#include "src/display/lv_display_private.h"
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static wayland_render_stats_t stats;
+static bool log_stats = false;
+static lv_display_flush_cb_t driver_flush_cb;
+static uint32_t frame_areas = 0;
+
+static bool env_enabled(const char *name)
+{
+    const char *value = getenv(name);
+    return value != NULL && strcmp(value, "0") != 0;
+}
+
+static void counting_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    uint32_t px = (uint32_t)lv_area_get_size(area);
+
+    stats.flushes++;
+    stats.damaged_px += px;
+    stats.last_frame_px += px;
+    frame_areas++;
+
+    driver_flush_cb(disp, area, px_map);
+    if (!lv_display_flush_is_last(disp)) {
+        return;
+    }
+
+    uint32_t screen_px = (uint32_t)(lv_display_get_horizontal_resolution(disp) *
+                                    lv_display_get_vertical_resolution(disp));
+    stats.frames++;
+    if (stats.last_frame_px >= screen_px) {
+        stats.full_frames++;
+    }
+    if (log_stats) {
+        TRACKER_LOG(TRACKER_LOG_INFO, "Wayland commit: frame %u, %u areas, %u px damaged (%.1f%% of the window)\n",
+                    (unsigned)stats.frames, (unsigned)frame_areas, (unsigned)stats.last_frame_px,
+                    screen_px ? 100.0 * stats.last_frame_px / screen_px : 0.0);
+    }
+    stats.last_frame_px = 0;
+    frame_areas = 0;
+}
+
+void wayland_render_setup(lv_display_t *disp)
+{
+    log_stats = env_enabled("UPDATE_TRACKER_WL_STATS");
+    driver_flush_cb = disp->flush_cb;
+    if (driver_flush_cb == NULL) {
+        return;
+    }
+    lv_display_set_flush_cb(disp, counting_flush_cb);
+}
+
+const wayland_render_stats_t *wayland_render_get_stats(void)
+{
+    return &stats;
+}
+
+#endif /* LV_USE_WAYLAND */
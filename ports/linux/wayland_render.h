@@ -0,0 +1,43 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2024 NXP
+ */
+
+#ifndef WAYLAND_RENDER_H_
+#define WAYLAND_RENDER_H_
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#if LV_USE_WAYLAND
+
+/*
+ * Damage accounting of the Wayland window, to check on a kiosk that the
+ * commits only damage what changed. LVGL's driver owns the wl_shm buffers,
+ * the damage requests and the frame callbacks, and exposes none of them, so
+ * this module neither reuses buffers nor paces commits: it measures the
+ * areas LVGL flushes into each commit. UPDATE_TRACKER_WL_STATS=1 logs every
+ * commit.
+ */
+typedef struct {
+    uint32_t frames;            // commits
+    uint32_t flushes;           // flushed areas, each damaged separately
+    uint64_t damaged_px;        // pixels damaged
+    uint32_t last_frame_px;
+    uint32_t full_frames;       // commits that damaged the whole window
+} wayland_render_stats_t;
+
+/**
+ * Wrap the flush callback of the Wayland window
+ * @param disp display of lv_wayland_window_create()
+ */
+void wayland_render_setup(lv_display_t *disp);
+
+/**
+ * @return commit statistics since startup
+ */
+const wayland_render_stats_t *wayland_render_get_stats(void);
+
+#endif /* LV_USE_WAYLAND */
+
+#endif /* WAYLAND_RENDER_H_ */
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright 2024 NXP
+"""View the display mirror of the update tracker.
+
+Usage:
+    ssh -L 5900:127.0.0.1:5900 root@target     # with UPDATE_TRACKER_MIRROR_PORT=5900
+    fb_mirror_view.py [--host HOST] [--port PORT] [--output FILE.ppm] [--stats]
+
+Shows the screen in a window, or with --output rewrites a PPM image after
+every frame. The stream is described in ports/linux/fb_mirror.h.
+"""
+
+import argparse
+import array
+import os
+import socket
+import struct
+import sys
+import time
+
+MSG = struct.Struct("<HHHHHHI")
+MSG_HELLO, MSG_RECT, MSG_FRAME_END = 1, 2, 3
+FORMAT_RGB565_RLE = 1
+
+
+def read_exact(sock, size):
+    buf = bytearray()
+    while len(buf) < size:
+        chunk = sock.recv(size - len(buf))
+        if not chunk:
+            raise EOFError("mirror closed the connection")
+        buf += chunk
+    return bytes(buf)
+
+
+def decode_rle(payload, w, h):
+    """Return the w x h rectangle as an array of RGB565 pixels"""
+    units = array.array("H")
+    units.frombytes(payload)
+    if sys.byteorder != "little":
+        units.byteswap()
+    px = array.array("H")
+    i = 0
+    while i < len(units):
+        token = units[i]
+        if token & 0x8000:
+            px.extend(array.array("H", [units[i + 1]]) * ((token & 0x7FFF) + 1))
+            i += 2
+        else:
+            px.extend(units[i + 1:i + 2 + token])
+            i += token + 2
+    if len(px) != w * h:
+        raise ValueError("rectangle of %d pixels decoded to %d" % (w * h, len(px)))
+    return px
+
+
+class Screen:
+    def __init__(self, width, height):
+        self.width = width
+        self.height = height
+        self.rgb = bytearray(width * height * 3)
+        self.lut = None
+
+    def blit(self, x, y, w, h, px):
+        if self.lut is None:
+            # Expansion of each RGB565 value to RGB888, built once
+            self.lut = [bytes((((v >> 11) & 0x1F) * 255 // 31, ((v >> 5) & 0x3F) * 255 // 63,
+                               (v & 0x1F) * 255 // 31)) for v in range(65536)]
+        lut = self.lut
+        for row in range(h):
+            line = b"".join(lut[v] for v in px[row * w:(row + 1) * w])
+            start = ((y + row) * self.width + x) * 3
+            self.rgb[start:start + w * 3] = line
+
+    def ppm(self):
+        return b"P6\n%d %d\n255\n" % (self.width, self.height) + bytes(self.rgb)
+
+
+def write_ppm(path, screen):
+    tmp = path + ".tmp"
+    with open(tmp, "wb") as f:
+        f.write(screen.ppm())
+    os.replace(tmp, path)
+
+
+def frames(sock, stats):
+    """Yield the screen after every frame"""
+    screen = None
+    frame_bytes = 0
+    while True:
+        msg_type, x, y, w, h, _, length = MSG.unpack(read_exact(sock, MSG.size))
+        payload = read_exact(sock, length) if length else b""
+        frame_bytes += MSG.size + length
+        if msg_type == MSG_HELLO:
+            if x != FORMAT_RGB565_RLE:
+                sys.exit("fb_mirror_view: unsupported pixel format %d" % x)
+            screen = Screen(w, h)
+        elif msg_type == MSG_RECT and screen is not None:
+            screen.blit(x, y, w, h, decode_rle(payload, w, h))
+        elif msg_type == MSG_FRAME_END and screen is not None:
+            if stats:
+                print("%.3f frame %d bytes" % (time.time(), frame_bytes), file=sys.stderr)
+            frame_bytes = 0
+            yield screen
+
+
+def show_window(sock, stats):
+    import tkinter
+
+    root = tkinter.Tk()
+    root.title("Update tracker mirror")
+    label = tkinter.Label(root)
+    label.pack()
+    stream = frames(sock, stats)
+
+    def update():
+        try:
+            screen = next(stream)
+        except EOFError as e:
+            print("fb_mirror_view: %s" % e, file=sys.stderr)
+            root.destroy()
+            return
+        image = tkinter.PhotoImage(data=screen.ppm(), format="PPM")
+        label.configure(image=image)
+        label.image = image
+        root.after(1, update)
+
+    root.after(1, update)
+    root.mainloop()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=5900)
+    parser.add_argument("--output", help="rewrite this PPM image after every frame instead of a window")
+    parser.add_argument("--stats", action="store_true", help="print the bytes of every frame")
+    args = parser.parse_args()
+
+    sock = socket.create_connection((args.host, args.port))
+    if args.output:
+        try:
+            for screen in frames(sock, args.stats):
+                write_ppm(args.output, screen)
+        except EOFError as e:
+            sys.exit("fb_mirror_view: %s" % e)
+    else:
+        show_window(sock, args.stats)
+
+
+if __name__ == "__main__":
+    main()
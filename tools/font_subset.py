@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright 2024 NXP
+"""Cut an LVGL font (lv_font_conv / GUI Guider C output) down to a charset.
+
+Usage:
+    font_subset.py --font lv_font_x.c --charset x.txt --output out.c [--fallback full.c]
+
+Only the glyphs of the characters listed in the charset file are kept, the
+bitmaps, glyph descriptors, character map and kerning class mappings are
+rebuilt for them. Everything else in the font (metrics, kerning values) is
+copied unchanged, so the public font symbol stays the same.
+
+With --fallback the untouched font is written as well, renamed to
+<name>_full, and the subset falls back to it for characters outside the
+charset.
+"""
+
+import argparse
+import re
+import sys
+
+
+def fail(msg):
+    sys.exit("font_subset: " + msg)
+
+
+def section(text, start_pattern, end="};"):
+    """Return (start, end) of the body between start_pattern and the closing brace."""
+    m = re.search(start_pattern, text)
+    if not m:
+        fail("cannot find " + start_pattern)
+    body_start = text.index("{", m.end() - 1) + 1
+    body_end = text.index(end, body_start)
+    return body_start, body_end
+
+
+def parse_numbers(body):
+    return [int(v, 0) for v in re.findall(r"-?0x[0-9a-fA-F]+|-?\d+", re.sub(r"/\*.*?\*/", "", body, flags=re.S))]
+
+
+def parse_bitmaps(text):
+    start, end = section(text, r"glyph_bitmap\[\]\s*=\s*\{")
+    body = text[start:end]
+    glyphs = []
+    for m in re.finditer(r"/\* U\+([0-9A-Fa-f]+) .*?\*/(.*?)(?=/\* U\+|\Z)", body, flags=re.S):
+        glyphs.append((int(m.group(1), 16), parse_numbers(m.group(2))))
+    return glyphs, start, end
+
+
+def parse_glyph_dsc(text):
+    start, end = section(text, r"glyph_dsc\[\]\s*=\s*\{")
+    entries = []
+    for m in re.finditer(r"\{([^{}]*)\}", text[start:end]):
+        fields = dict(re.findall(r"\.(\w+)\s*=\s*(-?\d+)", m.group(1)))
+        entries.append({k: int(v) for k, v in fields.items()})
+    return entries, start, end
+
+
+def parse_cmaps(text):
+    """Map every code point of the font to its glyph id."""
+    start, end = section(text, r"cmaps\[\]\s*=\s*\{", end="\n};")
+    mapping = {}
+    for m in re.finditer(r"\{([^{}]*)\}", text[start:end]):
+        f = dict(re.findall(r"\.(\w+)\s*=\s*([\w]+)", m.group(1)))
+        range_start = int(f["range_start"])
+        range_length = int(f["range_length"])
+        gid_start = int(f["glyph_id_start"])
+        kind = f["type"]
+        ofs_list = None
+        if f.get("glyph_id_ofs_list", "NULL") != "NULL":
+            s, e = section(text, re.escape(f["glyph_id_ofs_list"]) + r"\[\]\s*=\s*\{")
+            ofs_list = parse_numbers(text[s:e])
+        if kind.endswith("FORMAT0_TINY"):
+            for i in range(range_length):
+                mapping[range_start + i] = gid_start + i
+        elif kind.endswith("FORMAT0_FULL"):
+            for i in range(range_length):
+                mapping[range_start + i] = gid_start + ofs_list[i]
+        else:
+            s, e = section(text, re.escape(f["unicode_list"]) + r"\[\]\s*=\s*\{")
+            unicode_list = parse_numbers(text[s:e])
+            for i, ofs in enumerate(unicode_list):
+                gid = gid_start + (ofs_list[i] if kind.endswith("SPARSE_FULL") else i)
+                mapping[range_start + ofs] = gid
+    return mapping
+
+
+def format_array(values, per_line=16, indent="    "):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join(str(v) for v in values[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+def format_hex(values, per_line=8, indent="    "):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join("0x%x" % v for v in values[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+def glyph_comment(cp):
+    ch = chr(cp)
+    if ch == '"' or ch == "\\":
+        ch = "\\" + ch
+    elif cp > 0x7e or cp < 0x20:
+        ch = ""
+    return '/* U+%04X "%s" */' % (cp, ch)
+
+
+def subset(text, charset, font_name, fallback):
+    glyphs, bm_start, bm_end = parse_bitmaps(text)
+    dsc, dsc_start, dsc_end = parse_glyph_dsc(text)
+    cp_to_gid = parse_cmaps(text)
+
+    if re.search(r"\.bitmap_format\s*=\s*0", text) is None:
+        fail("compressed bitmaps are not supported")
+    if re.search(r"\.kern_classes\s*=\s*1", text) is None and "kern_pair_glyph_ids" in text:
+        fail("pair based kerning is not supported")
+    if len(dsc) != len(glyphs) + 1:
+        fail("glyph descriptors and bitmaps do not match")
+
+    gid_bitmap = {i + 1: bits for i, (_, bits) in enumerate(glyphs)}
+    missing = sorted(cp for cp in charset if cp not in cp_to_gid)
+    if missing:
+        print("font_subset: %s has no glyph for %s" % (font_name, " ".join("U+%04X" % cp for cp in missing)),
+              file=sys.stderr)
+    kept = sorted(cp for cp in charset if cp in cp_to_gid)
+    if not kept:
+        fail("no character of the charset is in the font")
+
+    # Bitmaps and glyph descriptors, new glyph ids follow code point order
+    bitmap_out, dsc_out = [], []
+    dsc_out.append("    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */")
+    old_ids = [0]
+    index = 0
+    for cp in kept:
+        gid = cp_to_gid[cp]
+        bits = gid_bitmap[gid]
+        d = dsc[gid]
+        bitmap_out.append("    " + glyph_comment(cp))
+        if bits:
+            bitmap_out.append(format_hex(bits))
+            bitmap_out[-1] += ","
+        bitmap_out.append("")
+        dsc_out.append("    {.bitmap_index = %d, .adv_w = %d, .box_w = %d, .box_h = %d, .ofs_x = %d, .ofs_y = %d}" %
+                       (index, d["adv_w"], d["box_w"], d["box_h"], d["ofs_x"], d["ofs_y"]))
+        old_ids.append(gid)
+        index += len(bits)
+    bitmap_body = "\n" + "\n".join(bitmap_out).rstrip(",\n") + "\n"
+
+    # A single map: indexed directly when the charset is one contiguous range,
+    # found with a binary search over one short list otherwise
+    range_start = kept[0]
+    offsets = [cp - range_start for cp in kept]
+    if offsets[-1] > 0xffff:
+        fail("charset spans more than 65536 code points")
+    if offsets[-1] + 1 == len(kept):
+        cmap_text = (
+            "\n\n/*Collect the unicode lists and glyph_id offsets*/\n"
+            "static const lv_font_fmt_txt_cmap_t cmaps[] =\n{\n"
+            "    {\n"
+            "        .range_start = %d, .range_length = %d, .glyph_id_start = 1,\n"
+            "        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY\n"
+            "    }\n};\n\n"
+        ) % (range_start, len(kept))
+    else:
+        cmap_text = (
+            "\n\nstatic const uint16_t unicode_list_0[] = {\n%s\n};\n\n"
+            "/*Collect the unicode lists and glyph_id offsets*/\n"
+            "static const lv_font_fmt_txt_cmap_t cmaps[] =\n{\n"
+            "    {\n"
+            "        .range_start = %d, .range_length = %d, .glyph_id_start = 1,\n"
+            "        .unicode_list = unicode_list_0, .glyph_id_ofs_list = NULL, .list_length = %d, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY\n"
+            "    }\n};\n\n"
+        ) % (format_hex(offsets), range_start, offsets[-1] + 1, len(kept))
+
+    out = text
+    # Replace from the end so earlier offsets stay valid
+    ks, ke = section(out, r"kern_right_class_mapping\[\]\s*=\s*\{")
+    right = parse_numbers(out[ks:ke])
+    out = out[:ks] + "\n" + format_array([right[g] for g in old_ids], 8) + "\n" + out[ke:]
+    ks, ke = section(out, r"kern_left_class_mapping\[\]\s*=\s*\{")
+    left = parse_numbers(out[ks:ke])
+    out = out[:ks] + "\n" + format_array([left[g] for g in old_ids], 8) + "\n" + out[ke:]
+
+    cm = re.search(r"(\*  CHARACTER MAPPING\n \*-+\*/)(.*?)(/\*-+\n \*    KERNING)", out, flags=re.S)
+    if not cm:
+        fail("cannot find the character mapping section")
+    out = out[:cm.start(2)] + cmap_text + out[cm.end(2):]
+
+    _, dsc_start, dsc_end = parse_glyph_dsc(out)
+    out = out[:dsc_start] + "\n" + ",\n".join(dsc_out) + "\n" + out[dsc_end:]
+    _, bm_start, bm_end = parse_bitmaps(out)
+    out = out[:bm_start] + bitmap_body + out[bm_end:]
+
+    out = re.sub(r"\.cmap_num\s*=\s*\d+", ".cmap_num = 1", out)
+    if fallback:
+        out = out.replace(".fallback = NULL", ".fallback = &%s_full" % font_name)
+        out = out.replace("#if LV_%s" % font_name[3:].upper(),
+                          "extern const lv_font_t %s_full;\n\n#if LV_%s" % (font_name, font_name[3:].upper()), 1)
+    header = "/* Subset of %d glyphs generated by tools/font_subset.py, do not edit */\n" % len(kept)
+    return header + out, len(kept), len(glyphs), index, sum(len(b) for _, b in glyphs)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--font", required=True, help="font C file")
+    ap.add_argument("--charset", required=True, help="UTF-8 text file with the characters to keep")
+    ap.add_argument("--output", required=True, help="subset font C file to write")
+    ap.add_argument("--fallback", help="also write the full font here, renamed to <name>_full")
+    args = ap.parse_args()
+
+    with open(args.font, encoding="utf-8") as f:
+        text = f.read()
+    with open(args.charset, encoding="utf-8") as f:
+        # Line breaks only separate groups of characters
+        charset = {ord(c) for c in f.read() if c not in "\r\n"}
+
+    m = re.search(r"lv_font_t\s+(\w+)\s*=", text)
+    if not m:
+        fail("cannot find the font descriptor in " + args.font)
+    font_name = m.group(1)
+
+    out, kept, total, bytes_kept, bytes_total = subset(text, charset, font_name, args.fallback is not None)
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(out)
+
+    if args.fallback:
+        full = re.sub(r"\b%s\b" % font_name, font_name + "_full", text)
+        with open(args.fallback, "w", encoding="utf-8") as f:
+            f.write(full)
+
+    print("font_subset: %s: %d of %d glyphs, %d of %d bitmap bytes" %
+          (font_name, kept, total, bytes_kept, bytes_total))
+
+
+if __name__ == "__main__":
+    main()
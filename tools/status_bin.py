@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright 2024 NXP
+"""Convert JSON status documents into the binary status record.
+
+Usage:
+    status_bin.py RECORD [DOCUMENT...]
+    producer | status_bin.py RECORD -
+    status_bin.py --dump RECORD
+
+Each document (a file, or one JSON object per line on stdin with "-") is
+applied on top of the status already in the record, keys that are missing
+keep their value, as with the JSON status file. The record is updated in
+place under its sequence lock, see custom/status_binary.h, so the tracker
+can keep it mapped. Never replace the record file with a rename.
+"""
+
+import argparse
+import json
+import mmap
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = 0x52535455
+VERSION = 1
+TEXT_LEN = 64
+ID_LEN = 32
+
+# status_record_t, little-endian
+HEADER = struct.Struct("<IHHI")
+PAYLOAD = struct.Struct("<iiiqq%ds%ds%ds%ds" % (TEXT_LEN, TEXT_LEN, TEXT_LEN, ID_LEN))
+TRAILER = struct.Struct("<II")
+SIZE = HEADER.size + PAYLOAD.size + TRAILER.size
+SEQ_OFFSET = 8
+
+FIELDS = ("progress", "eta", "error_code", "bytes_done", "bytes_total", "status", "step", "component", "id")
+TEXT_FIELDS = {"status": TEXT_LEN, "step": TEXT_LEN, "component": TEXT_LEN, "id": ID_LEN}
+
+assert SIZE == 272
+
+
+def fail(msg):
+    sys.exit("status_bin: " + msg)
+
+
+def open_record(path):
+    fd = os.open(path, os.O_RDWR | os.O_CREAT, 0o644)
+    try:
+        if os.fstat(fd).st_size < SIZE:
+            os.ftruncate(fd, SIZE)
+        return mmap.mmap(fd, SIZE)
+    finally:
+        os.close(fd)
+
+
+def open_record_readonly(path):
+    """Map an existing record without creating or resizing it"""
+    try:
+        fd = os.open(path, os.O_RDONLY)
+    except OSError as e:
+        fail("cannot open %s: %s" % (path, e.strerror))
+    try:
+        if os.fstat(fd).st_size < SIZE:
+            fail("%s is not a status record, it is shorter than %d bytes" % (path, SIZE))
+        return mmap.mmap(fd, SIZE, access=mmap.ACCESS_READ)
+    finally:
+        os.close(fd)
+
+
+def decode(rec):
+    magic, version, size, seq = HEADER.unpack_from(rec, 0)
+    status = {"progress": 0, "eta": -1, "error_code": 0, "bytes_done": 0, "bytes_total": 0,
+              "status": "", "step": "", "component": "", "id": ""}
+    if magic != MAGIC:
+        return seq, status
+    if version != VERSION or size != SIZE:
+        fail("unsupported record version %d, size %d" % (version, size))
+    for name, value in zip(FIELDS, PAYLOAD.unpack_from(rec, HEADER.size)):
+        status[name] = value.split(b"\0", 1)[0].decode("utf-8", "replace") if name in TEXT_FIELDS else value
+    return seq, status
+
+
+def encode_text(value, size):
+    # Cut on a character boundary, leaving room for the terminating NUL
+    return str(value).encode("utf-8")[:size - 1].decode("utf-8", "ignore").encode("utf-8")
+
+
+def publish(rec, status):
+    seq = struct.unpack_from("<I", rec, SEQ_OFFSET)[0] | 1
+    values = [encode_text(status[n], TEXT_FIELDS[n]) if n in TEXT_FIELDS else int(status[n]) for n in FIELDS]
+    payload = PAYLOAD.pack(*values)
+
+    # Odd while writing; the CRC still catches a reader that saw the stores out of order
+    struct.pack_into("<I", rec, SEQ_OFFSET, seq)
+    HEADER.pack_into(rec, 0, MAGIC, VERSION, SIZE, seq)
+    rec[HEADER.size:HEADER.size + PAYLOAD.size] = payload
+    TRAILER.pack_into(rec, HEADER.size + PAYLOAD.size, zlib.crc32(payload) & 0xffffffff, 0)
+    struct.pack_into("<I", rec, SEQ_OFFSET, (seq + 1) & 0xffffffff)
+
+
+def documents(args):
+    for name in args:
+        if name == "-":
+            for line in sys.stdin:
+                if line.strip():
+                    yield line
+        else:
+            with open(name, encoding="utf-8") as f:
+                yield f.read()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("record", help="binary record, created if missing unless dumped")
+    parser.add_argument("documents", nargs="*", help="JSON documents, - for one per line on stdin")
+    parser.add_argument("--dump", action="store_true", help="print the record as JSON and exit")
+    args = parser.parse_args()
+
+    if args.dump:
+        seq, status = decode(open_record_readonly(args.record))
+        status["seq"] = seq >> 1
+        print(json.dumps(status, indent=4))
+        return
+
+    rec = open_record(args.record)
+    seq, status = decode(rec)
+
+    for text in documents(args.documents):
+        try:
+            doc = json.loads(text)
+        except ValueError as e:
+            print("status_bin: skipped malformed document: %s" % e, file=sys.stderr)
+            continue
+        status.update({k: v for k, v in doc.items() if k in FIELDS})
+        publish(rec, status)
+        rec.flush()
+
+
+if __name__ == "__main__":
+    main()